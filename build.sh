@@ -35,6 +35,12 @@ make
 # -r flag copies directories recursively
 cp -r ../assets ./
 
+# Generate the single-token endgame tablebase used by computer opponents
+# Skipped when it already exists since solving takes a little while
+if [ ! -f assets/endgame-1.tb ]; then
+    ./ludo_tablebase 1 assets/endgame-1.tb
+fi
+
 # Set executable permissions for the game binary
 # +x adds execute permission for all users
 chmod +x MultiLudo
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Rules.h"
+#include "Simulator.h"
+#include "Stats.h"
+#include <cstdint>
+
+/** @brief Number of games advanced together by the batch engine */
+const int BATCH_LANES = 8;
+
+/**
+ * @brief Name of the vector kernel compiled in ("AVX2", "SSE4.1" or "scalar")
+ */
+const char* BatchKernelName();
+
+/**
+ * @brief Lockstep simulator running BATCH_LANES greedy games side by side
+ *
+ * Token positions, the mover and the current die are kept per lane in
+ * structure-of-arrays form, and one vector kernel computes move targets,
+ * the home-column bound, capture masks and the greedy choice for every
+ * lane at once. Rolling dice, turn order and bookkeeping stay scalar per
+ * lane. Game g of a run uses SimGameSeed(seed, g), so the results match
+ * SimulateGame with SimGreedyPolicy game for game.
+ */
+class BatchSimulator {
+public:
+    /**
+     * @param tokens Tokens per player
+     * @param seed Base seed of the run
+     * @param stats Aggregates to update (not shared with other threads)
+     */
+    BatchSimulator(int tokens, uint64_t seed, SimStats* stats);
+
+    /**
+     * @brief Plays the games with indices [first, last)
+     * @return Number of games played
+     */
+    long long Run(long long first, long long last);
+
+private:
+    /**
+     * @brief Scalar per-lane state: turn order, dice queue and results
+     */
+    struct Lane {
+        SimRng rng;
+        SimTurnOrder order;
+        bool active;
+        bool done[CLASSIC_PLAYERS];
+        int places[CLASSIC_PLAYERS];
+        int placed;
+        int turns;
+        int player;
+        int dice[RULES_MAX_DICE];
+        int numDice;
+        int next;       ///< Index of the next die in the queue
+
+        Lane() : rng(0) {}
+    };
+
+    bool StartGame(int lane);
+    void EndGame(int lane);
+    void PrepareLane(int lane);
+    void FinishLane(int lane);
+    bool AllFinished(int lane, int player) const;
+    void Step();
+
+    int tokens;
+    int maxTurns;       ///< Turn limit, as SimulateGame sets it for the classic board
+    uint64_t seed;
+    SimStats* stats;
+    long long nextGame;
+    long long lastGame;
+    Lane lanes[BATCH_LANES];
+
+    // Vector state, one int32 per lane
+    alignas(32) int32_t pos[CLASSIC_PLAYERS][CLASSIC_TOKENS][BATCH_LANES];
+    alignas(32) int32_t home[CLASSIC_PLAYERS][BATCH_LANES];    ///< -1 once the player may go home
+    alignas(32) int32_t player[BATCH_LANES];
+    alignas(32) int32_t die[BATCH_LANES];                         ///< 0 when the lane has nothing to play
+
+    // Kernel results
+    alignas(32) int32_t chosen[BATCH_LANES];      ///< Token moved, or -1
+    alignas(32) int32_t movedTo[BATCH_LANES];     ///< Its new position
+    alignas(32) int32_t captured[BATCH_LANES];    ///< Opponent tokens sent home
+};
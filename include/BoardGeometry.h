@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstdint>
+
+/** @brief Most arms (and so players) a board can have */
+const int BOARD_MAX_ARMS = 8;
+
+/** @brief Most cells along one side of an arm */
+const int BOARD_MAX_LANE = 8;
+
+/** @brief Most cells on the shared outer track */
+const int BOARD_MAX_TRACK = 128;
+
+/** @brief Relative positions are stored in a byte */
+const int BOARD_MAX_POS = 256;
+
+/** @brief Yard spots laid out per player */
+const int BOARD_YARD_SLOTS = 8;
+
+/** @brief Boards the registry can hold, built-in ones included */
+const int BOARD_MAX_BOARDS = 8;
+
+/** @brief Registry id of the classic four-player board */
+const int BOARD_CLASSIC = 0;
+
+/** @brief First spot id of the home column cells; track cells come before */
+const int BOARD_SPOT_HOME = BOARD_MAX_TRACK;
+
+/** @brief First spot id of the yard spots */
+const int BOARD_SPOT_YARD = BOARD_SPOT_HOME + BOARD_MAX_ARMS * BOARD_MAX_LANE;
+
+/** @brief Number of spot ids: every square a token can be drawn on */
+const int BOARD_MAX_SPOTS = BOARD_SPOT_YARD + BOARD_MAX_ARMS * BOARD_YARD_SLOTS;
+
+/** @brief Cell-sized hit-test buckets along each side of a board */
+const int BOARD_HIT_GRID = 40;
+
+/** @brief Spots one bucket can list; rotated arms put up to five squares over a bucket */
+const int BOARD_HIT_SLOTS = 8;
+
+/** @brief Top-left pixel of a cell-sized square on the board */
+struct BoardPoint {
+    int16_t x;
+    int16_t y;
+};
+
+/**
+ * @brief Board topology and its precomputed lookup tables
+ *
+ * A board has one arm per player around a central finish area. Each arm is
+ * lane cells out, a tip cell and lane cells back in; the inward side of the
+ * owner's arm leads into its home column of lane - 1 cells, and its start
+ * cell is the second cell of that inward side. The arms form one shared
+ * track of arms * (2 * lane + 1) cells.
+ *
+ * Everything the rules and the renderer need per move is a table lookup, so
+ * a move costs the same on a 4-, 6- or 8-arm board. The same holds for
+ * mapping a click to the square under it: the board is cut into cell-sized
+ * buckets that list the spots overlapping them.
+ *
+ * A board is described by a few text lines, '#' starting a comment:
+ *   arms 6          players (and arms), 2..8
+ *   lane 6          cells along one side of an arm
+ *   safe 3 8        indices within every arm that are safe squares
+ *   cell 46         cell size in pixels
+ *   inner 0         cells from the centre to the first cell of an arm; 0 picks
+ *                   the smallest value that keeps neighbouring arms apart
+ *   yard 0 x y ...  explicit yard spots of a player, up to 8 (optional)
+ */
+struct BoardGeometry {
+    int arms;                   ///< Arms and players
+    int lane;                   ///< Cells along one side of an arm
+    uint32_t safeArmCells;      ///< Bit per safe index within an arm
+    int cellSize;               ///< Cell size in pixels
+    int inner;                  ///< Cells from the centre to the first cell of an arm
+
+    int armLength;              ///< Track cells per arm, 2 * lane + 1
+    int start;                  ///< Index within an arm of its owner's start cell, lane + 2
+    int trackLength;            ///< Cells on the shared track
+    int tip;                    ///< Relative position of the owner's arm tip
+    int homeFirst;              ///< Relative position of the first home column cell
+    int finished;               ///< Relative position of a finished token
+    int size;                   ///< Board width and height in pixels
+
+    int8_t cell[BOARD_MAX_ARMS][BOARD_MAX_POS];             ///< Relative position -> track cell, -1 off the track
+    uint64_t safe[BOARD_MAX_TRACK / 64];                    ///< Bit per safe track cell
+    BoardPoint track[BOARD_MAX_TRACK];                      ///< Pixel of every track cell
+    BoardPoint home[BOARD_MAX_ARMS][BOARD_MAX_LANE + 1];    ///< Pixel of home column index 1..lane (lane is the finish)
+    BoardPoint yard[BOARD_MAX_ARMS][BOARD_YARD_SLOTS];      ///< Pixel of every yard spot
+    float armAngle[BOARD_MAX_ARMS];                         ///< Direction of every arm from the centre, in degrees
+    int16_t hit[BOARD_HIT_GRID][BOARD_HIT_GRID][BOARD_HIT_SLOTS];  ///< Spots overlapping every bucket, -1 padded
+
+    /**
+     * @brief Checks if a track cell is marked safe by the board
+     * @param c Track cell, or -1
+     */
+    bool IsSafe(int c) const { return c >= 0 && ((safe[c >> 6] >> (c & 63)) & 1); }
+
+    /**
+     * @brief Pixel of a token on the track or in its home column
+     * @param player 0-based owner of the token
+     * @param pos Relative position, not the yard
+     */
+    BoardPoint Pixel(int player, int pos) const {
+        return pos >= homeFirst ? home[player][pos - trackLength] : track[cell[player][pos]];
+    }
+
+    /**
+     * @brief Spot a token is drawn on
+     * @param player 0-based owner of the token
+     * @param token Index of the token, which picks its yard spot
+     * @param pos Relative position
+     * @return Spot id, or -1 once finished
+     */
+    int Spot(int player, int token, int pos) const {
+        if (pos == 0) return BOARD_SPOT_YARD + player * BOARD_YARD_SLOTS + token;
+        if (pos >= finished) return -1;
+        if (pos >= homeFirst) return BOARD_SPOT_HOME + player * BOARD_MAX_LANE + pos - trackLength;
+        return cell[player][pos];
+    }
+
+    /**
+     * @brief Top-left pixel of a spot
+     */
+    BoardPoint SpotPixel(int spot) const {
+        if (spot >= BOARD_SPOT_YARD) {
+            spot -= BOARD_SPOT_YARD;
+            return yard[spot / BOARD_YARD_SLOTS][spot % BOARD_YARD_SLOTS];
+        }
+        if (spot >= BOARD_SPOT_HOME) {
+            spot -= BOARD_SPOT_HOME;
+            return home[spot / BOARD_MAX_LANE][spot % BOARD_MAX_LANE];
+        }
+        return track[spot];
+    }
+
+    /**
+     * @brief Finds the spots whose square contains a pixel
+     * @param x Pixel column
+     * @param y Pixel row
+     * @param out Receives up to BOARD_HIT_SLOTS spot ids
+     * @return Number of spots written
+     */
+    int SpotsAt(int x, int y, int* out) const;
+};
+
+/**
+ * @brief Builds a board from its text description
+ * @param text Description lines as documented on BoardGeometry
+ * @param g Board to fill
+ * @return true if the description was complete and within the limits
+ */
+bool ParseBoardGeometry(const char* text, BoardGeometry& g);
+
+/**
+ * @brief Reads a board description from a file
+ * @return true on success; errors are printed
+ */
+bool LoadBoardGeometry(const char* path, BoardGeometry& g);
+
+/**
+ * @brief Adds a board to the registry
+ *
+ * Boards are looked up without locking, so register them before any game or
+ * simulation thread starts.
+ *
+ * @return Registry id, or -1 if the registry is full
+ */
+int RegisterBoard(const BoardGeometry& g);
+
+/**
+ * @brief Registered boards, indexed by id
+ */
+struct BoardRegistry {
+    BoardGeometry boards[BOARD_MAX_BOARDS];     ///< Built-in boards first, then RegisterBoard's
+    int count;                                  ///< Boards registered
+
+    /** @brief Parses the built-in boards into the front of the registry */
+    BoardRegistry();
+};
+
+/**
+ * @brief The registry, built on first use
+ * A function-local static, so static initializers in any translation unit
+ * already see the built-in boards
+ */
+inline BoardRegistry& Boards() {
+    static BoardRegistry registry;
+    return registry;
+}
+
+/**
+ * @brief Registered board by id; the built-in 4-, 6- and 8-arm boards come first
+ */
+inline const BoardGeometry& Board(int id) { return Boards().boards[id]; }
+
+/**
+ * @brief Number of registered boards
+ */
+int BoardCount();
+
+/**
+ * @brief Registry id of the built-in board with the given number of arms
+ * @return Id, or -1 if there is none
+ */
+int StandardBoard(int arms);
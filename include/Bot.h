@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Rules.h"
+
+/**
+ * @brief Scores a move with a simple greedy heuristic
+ * Prefers captures, then finishing, entering and safe squares, then progress
+ * @param m Move to score
+ * @return Higher is better
+ */
+int GreedyScore(const LudoMove& m);
+
+/**
+ * @brief Chooses a move for the die at the front of a queue
+ *
+ * When only one opponent is left and an endgame tablebase covers the
+ * token count, every choice is scored by exact win probability over the
+ * rest of the queue. Otherwise the trained evaluator picks the move whose
+ * position scores best, or the greedy heuristic when no evaluator ships.
+ *
+ * @param s Current state
+ * @param player 0-based player to move
+ * @param dice Pending dice queue, front die first
+ * @param numDice Number of dice in the queue
+ * @param phase EndgamePhase of the player in the current round of turns
+ * @param out Receives the chosen move
+ * @return true if a legal move exists, false if the front die must be skipped
+ */
+bool BotChooseMove(const LudoState& s, int player, const int* dice, int numDice, int phase, LudoMove& out);
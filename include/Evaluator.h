@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Rules.h"
+#include <cstdint>
+
+/** @brief Hand-crafted features describing a position for one player */
+const int EVAL_FEATURES = 16;
+
+/** @brief Positions scored together; enough for every candidate move of a die */
+const int EVAL_LANES = 8;
+
+static_assert(RULES_MAX_TOKENS <= EVAL_LANES, "a batch holds every move of one die");
+
+/** @brief Identifies an evaluator weights file ("MLEV") */
+const uint32_t EVALUATOR_MAGIC = 0x56454C4D;
+
+/** @brief Evaluator file format version */
+const uint16_t EVALUATOR_VERSION = 1;
+
+/**
+ * @brief Header of an evaluator weights file; EVAL_FEATURES floats follow it
+ */
+struct EvaluatorHeader {
+    uint32_t magic;         ///< EVALUATOR_MAGIC
+    uint16_t version;       ///< EVALUATOR_VERSION
+    uint16_t features;      ///< EVAL_FEATURES when written
+    uint64_t games;         ///< Self-play games the weights were trained on
+};
+
+/**
+ * @brief Positions laid out feature by feature, one lane per position
+ *
+ * The structure-of-arrays form lets one vector multiply-add per feature
+ * score every position of the batch at once.
+ */
+struct EvalBatch {
+    alignas(32) float x[EVAL_FEATURES][EVAL_LANES];     ///< Feature f of position i is x[f][i]
+    int count;                                          ///< Positions in use
+};
+
+/**
+ * @brief Computes the features of a position from one player's point of view
+ *
+ * Progress, yard, home column and finished shares of the player's tokens,
+ * how many of them an opponent could hit with one die and how many sit on
+ * safe squares, the same measures for the opponents, and a bias term.
+ *
+ * @param s Position
+ * @param player 0-based player the features describe
+ * @param out Receives EVAL_FEATURES values
+ */
+void EvalFeatures(const LudoState& s, int player, float* out);
+
+/**
+ * @brief Linear position evaluator with a logistic output
+ *
+ * Estimates the finishing score of a player, 1 for first and 0 for last,
+ * as the logistic of a weighted sum of EvalFeatures. Weights are trained
+ * offline by ludo_train.
+ */
+class Evaluator {
+public:
+    Evaluator();
+
+    /**
+     * @brief Reads a weights file
+     * @return true if the file was read and its header is valid
+     */
+    bool Load(const char* path);
+
+    /**
+     * @brief Writes the weights to a file
+     * @param games Self-play games the weights were trained on
+     * @return true on success
+     */
+    bool Save(const char* path, uint64_t games) const;
+
+    /**
+     * @brief Scores one position
+     * @param features EVAL_FEATURES values from EvalFeatures
+     * @return Estimated finishing score in (0, 1)
+     */
+    float Value(const float* features) const;
+
+    /**
+     * @brief Scores every position of a batch with vector dot products
+     * @param batch Positions to score
+     * @param out Receives one estimate per position in use
+     */
+    void ScoreBatch(const EvalBatch& batch, float* out) const;
+
+    float weights[EVAL_FEATURES];   ///< Weight of every feature
+};
+
+/**
+ * @brief Name of the dot product kernel compiled in ("AVX2", "SSE4.1" or "scalar")
+ */
+const char* EvalKernelName();
+
+/**
+ * @brief Chooses the move for the front die whose resulting position scores best
+ * @param e Evaluator to score with
+ * @param s Current state
+ * @param player 0-based player to move
+ * @param dice Pending dice queue, front die first
+ * @param out Receives the chosen move
+ * @return true if a legal move exists, false if the front die must be skipped
+ */
+bool EvaluatorChooseMove(const Evaluator& e, const LudoState& s, int player, const int* dice, LudoMove& out);
+
+/**
+ * @brief Returns the shipped evaluator, reading it on first use
+ *
+ * Looks for evaluator.bin in the assets directory.
+ *
+ * @return Loaded evaluator, or nullptr if none is available
+ */
+const Evaluator* GetEvaluator();
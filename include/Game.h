@@ -1,9 +1,16 @@
 #pragma once
 
 #include "Player.h"
+#include "TurnScheduler.h"
+#include "SchedulerThread.h"
+#include "Utils.h"
+#include "Viewport.h"
+#include "Input.h"
+#include "Hint.h"
+#include "Replay.h"
 #include "raylib.h"
 #include <vector>
-#include <pthread.h>
+#include <string>
 
 /**
  * @brief Main game class that handles core game functionality and rendering
@@ -14,17 +21,41 @@
  */
 class Game {
 public:
-    static const int SCREEN_WIDTH = 1200;   ///< Window width in pixels
-    static const int SCREEN_HEIGHT = 900;   ///< Window height in pixels
+    static const int SCREEN_WIDTH = 1200;   ///< Logical canvas width; the window can be any size
+    static const int SCREEN_HEIGHT = 900;   ///< Logical canvas height
+    static const int FONT_TIERS = 3;        ///< Glyph atlases cached per resolution
+    static const int MAX_GLYPH_PIXELS = 256;  ///< Largest glyph size a font atlas is rendered at
+    static const int METRICS_EXPORT_SECONDS = 5;  ///< Interval between metrics file exports
+    static constexpr Rectangle REPLAY_BAR = {930, 670, 240, 14};  ///< Scrubber track on the replay screen
     int screen;                            ///< Current game screen/state identifier
-    Player P1, P2, P3, P4;                 ///< Player objects for all 4 players
-    pthread_t th[4];                       ///< Thread handles for player threads
+    Player players[BOARD_MAX_ARMS];        ///< One player per arm of the board; seats past its arms stay unused
+    TurnScheduler scheduler;               ///< Drives the turn coroutines of all players
+    SchedulerThread schedulerThread;       ///< Single thread that ticks the scheduler and latches clicks for it
     bool Initial;                          ///< Flag indicating initial game state
     std::vector<bool> FinishedThreads;     ///< Tracks completion status of player threads
     bool WinnerScreen;                     ///< Flag for displaying winner screen
-    Texture2D LudoBoard;                   ///< Main game board texture
-    Texture2D Dice[6];                     ///< Array of dice face textures
-    Font gameFont;                         ///< Font used for game text
+    bool botSeats;                         ///< Flag for letting the computer play every seat but RED
+    int selectedBoard;                     ///< Registry id of the board the next match is played on
+    Viewport viewport;                     ///< Maps the logical canvas onto the window
+    RaylibInput liveInput;                 ///< Mouse and keyboard of the window
+    ScriptedInput scriptedInput;           ///< Timeline of input loaded from a script
+    InputProvider* input;                  ///< Where the frame's input comes from
+    long frame;                            ///< Frames drawn so far
+    MatchRecord replay;                    ///< Match shown on the replay screen
+    int replayEvent;                       ///< Events of the replay played up to the position shown
+    ScaledTexture LudoBoard;               ///< Main game board texture
+    ScaledTexture Dice[6];                 ///< Array of dice face textures
+    TokenBatch tokenBatch;                 ///< Token atlas, loaded once, and the tokens queued each frame
+    HintTable hints;                       ///< Capture and home odds of the positions seen recently
+    bool showHints;                        ///< Flag for drawing the odds over every token
+    Font gameFonts[FONT_TIERS];            ///< Game font rendered for the window's resolution, smallest tier first
+    bool customFont;                       ///< False when the default font stands in for a missing font file
+    std::string savePath;                  ///< File the match is saved to on exit and resumed from
+    std::string resumePath;                ///< Snapshot to load before the first frame (empty for none)
+    std::string replayPath;                ///< File the match's replay is written to when it ends (empty for none)
+    std::string watchPath;                 ///< Replay to open before the first frame (empty for none)
+    double matchRequested;                 ///< GetTime() when a match was requested, -1 once it is playable
+    std::string metricsPath;               ///< Prometheus text file the metrics are exported to (empty for none)
 
     /**
      * @brief Default constructor
@@ -44,33 +75,136 @@ public:
     void Initialize();
 
     /**
-     * @brief Loads all required game textures into memory
+     * @brief Loads all required game images into memory
+     * Textures are made from them by RescaleAssets
      */
     void LoadTextures();
 
     /**
      * @brief Loads and initializes the game font
+     * Renders one glyph atlas per tier at the viewport's pixel density
      */
     void LoadGameFont();
 
+    /**
+     * @brief Renders textures, token atlas and glyph atlases for the current viewport
+     * Runs once per window resize or DPI change, never per frame
+     */
+    void RescaleAssets();
+
+    /**
+     * @brief Font atlas to draw or measure text of a logical size with
+     * @param fontSize Logical font size
+     */
+    const Font& FontFor(int fontSize) const;
+
+    /**
+     * @brief Mouse position on the logical canvas
+     */
+    Vector2 MousePosition() const;
+
     /**
      * @brief Sets up initial state for all players
      */
     void InitializePlayers();
 
+    /**
+     * @brief Sets every seat of the active board up with its color and tokens
+     */
+    void SeatPlayers();
+
+    /**
+     * @brief Creates the thread that ticks the turn scheduler schedulerThread.tickRate times per second
+     */
+    void StartScheduler();
+
+    /**
+     * @brief Stops the scheduler thread and waits for it to exit
+     * Requests a cooperative stop and waits at most SchedulerThread::SHUTDOWN_DEADLINE_MS;
+     * the measured latency is logged. A thread that misses the deadline is
+     * joined by the destructor
+     * @return true if the thread exited in time and the coroutines were destroyed
+     */
+    bool StopScheduler();
+
+    /**
+     * @brief Hands this frame's click to the next logic tick
+     * Called by the render loop when the left button is pressed
+     */
+    void LatchInput();
+
+    /**
+     * @brief Allocates the board grid and sets up players for a new match
+     * Uses the currently selected numTokens. The caller must hold the game mutex
+     */
+    void StartMatch();
+
+    /**
+     * @brief Destroys the turn coroutines and releases all per-match memory at once
+     * The caller must hold the game mutex
+     */
+    void EndMatch();
+
+    /**
+     * @brief Starts a new match from the win screen or menu and times it
+     * Keeps textures, the scheduler thread and the match arena
+     */
+    void Rematch();
+
+    /**
+     * @brief Writes the match record to replayPath
+     * The scheduler thread must not be running a tick
+     */
+    void SaveReplay();
+
+    /**
+     * @brief Loads a replay file and shows its opening position on the replay screen
+     * @return true if the file was read and the board set up
+     */
+    bool OpenReplay(const char* path);
+
+    /**
+     * @brief Shows the position after a number of events of the replay
+     * @param event Events to play; clamped to the replay
+     */
+    void SeekReplay(int event);
+
+    /**
+     * @brief Handles the replay screen's scrubber and keys
+     */
+    void UpdateReplay();
+
+    /**
+     * @brief Draws the replay scrubber and its key help
+     */
+    void DrawScrubber();
+
     /**
      * @brief Renders the game's start/menu screen
      */
     void DrawStartScreen();
 
+    /**
+     * @brief Draws the board of the current match
+     * The classic board uses its image; other boards are drawn from their geometry
+     */
+    void DrawBoard();
+
     /**
      * @brief Displays current score for all players
-     * @param p1 Player 1's score
-     * @param p2 Player 2's score
-     * @param p3 Player 3's score
-     * @param p4 Player 4's score
      */
-    void DrawScore(int p1, int p2, int p3, int p4);
+    void DrawScore();
+
+    /**
+     * @brief Displays the click-to-photon latency of each input stage
+     */
+    void DrawLatency();
+
+    /**
+     * @brief Draws the capture and home odds over every token
+     * @param s State of the match, copied under the game mutex
+     */
+    void DrawHints(const LudoState& s);
 
     /**
      * @brief Renders the current dice state
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Rules.h"
+#include <cstdint>
+
+/** @brief Turns of its owner within which the home probability is given */
+const int HINT_HOME_TURNS = 3;
+
+/**
+ * @brief Odds shown over one token
+ */
+struct TokenHint {
+    float captured;     ///< Estimated probability an opponent captures it before its owner's next turn
+    float home;         ///< Upper bound on the probability it finishes within HINT_HOME_TURNS turns of its owner
+};
+
+/**
+ * @brief Estimated per-token capture risk and home odds, memoized by board state
+ *
+ * Both go over every dice outcome of a turn (a six rolls again, a third six
+ * forfeits under GameRules), but neither follows the real turn order, so
+ * they are estimates rather than exact odds:
+ *  - captured: each opponent gets one turn from the current position and
+ *    is assumed to capture the token whenever some order of its dice
+ *    allows it; the opponents' turns are combined as independent, ignoring
+ *    how earlier opponents move the token's attackers or take the capture
+ *    themselves.
+ *  - home: the owner plays its best for this token, moving it or leaving a
+ *    die to another token, and the token is never captured on the way, so
+ *    this is an upper bound. It is a dynamic program over the token's
+ *    relative position that depends on the board only, so it is built once
+ *    per board and read per token.
+ *
+ * A few recent states are cached, so hints are computed when the position
+ * changes and not again for a frame, or a position returned to, that shows
+ * the same state.
+ */
+class HintTable {
+public:
+    HintTable();
+
+    /**
+     * @brief Hints for every token of a state
+     * @param s State of the match; turn and homeMask must be filled in
+     * @return Hints indexed [player][token], valid until the next call
+     */
+    const TokenHint (*Get(const LudoState& s))[RULES_MAX_TOKENS];
+
+    /**
+     * @brief States computed so far, as opposed to served from the cache
+     */
+    uint64_t Computed() const { return computed; }
+
+private:
+    static const int CACHE_SLOTS = 16;      ///< Recent states kept; a slot is picked by hash
+
+    /** @brief One cached state and its hints */
+    struct Entry {
+        LudoState key;                                              ///< State the hints are for
+        bool used;                                                  ///< Slot holds a state
+        TokenHint hints[RULES_MAX_PLAYERS][RULES_MAX_TOKENS];       ///< Hints of every token
+    };
+
+    /** @brief Fills an entry's hints for its key */
+    void Compute(Entry& e);
+
+    /** @brief Builds the home probability tables of a board */
+    void BuildHomeTable(int board);
+
+    Entry cache[CACHE_SLOTS];   ///< Hash-indexed recent states
+    Entry* last;                ///< Entry returned by the previous call, checked first
+    int homeBoard;              ///< Board the home tables are for, -1 before the first
+    float home[2][BOARD_MAX_POS];   ///< Home probability by [may enter home][relative position]
+    uint64_t computed;          ///< States computed so far
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "raylib.h"
+#include <vector>
+
+class Viewport;
+
+/**
+ * @brief Source of the mouse and keyboard input the game reacts to
+ *
+ * The render loop and the menus read input only through this interface,
+ * once per frame, and clicks reach the turn coroutines through the logic
+ * tick's latch. Swapping the provider drives the whole game, menus
+ * included, without a human at the window.
+ */
+class InputProvider {
+public:
+    virtual ~InputProvider() {}
+
+    /**
+     * @brief Advances to a new frame; called before any other query of the frame
+     * @param frame Frames drawn so far
+     * @param screen Screen about to be drawn (1 menu, 2 match, 3 win screen, 4 replay)
+     */
+    virtual void BeginFrame(long frame, int screen) = 0;
+
+    /**
+     * @brief Whether the left button was pressed this frame
+     */
+    virtual bool MousePressed() = 0;
+
+    /**
+     * @brief Whether the left button is held this frame
+     */
+    virtual bool MouseDown() = 0;
+
+    /**
+     * @brief Mouse position on the logical canvas
+     */
+    virtual Vector2 MousePosition() = 0;
+
+    /**
+     * @brief Whether a key was pressed this frame
+     * @param key raylib key code
+     */
+    virtual bool KeyPressed(int key) = 0;
+
+    /**
+     * @brief Whether the game should close, besides the window's own close button
+     */
+    virtual bool CloseRequested() = 0;
+};
+
+/**
+ * @brief Live input from the raylib window
+ */
+class RaylibInput : public InputProvider {
+public:
+    /**
+     * @param viewport Maps window positions to the logical canvas
+     */
+    explicit RaylibInput(const Viewport& viewport) : viewport(viewport) {}
+
+    void BeginFrame(long, int) override {}
+    bool MousePressed() override;
+    bool MouseDown() override;
+    Vector2 MousePosition() override;
+    bool KeyPressed(int key) override;
+    bool CloseRequested() override { return false; }
+
+private:
+    const Viewport& viewport;
+};
+
+/**
+ * @brief Replays a timeline of clicks and key presses
+ *
+ * A script has one event per line, '#' starting a comment:
+ *   30 key B          press a key at frame 30: one character, ENTER, SPACE, LEFT,
+ *                     RIGHT or a key code
+ *   31 click 600 640  left click at a logical position at frame 31
+ *   every 12 click 1040 550
+ *                     repeat an action every 12 frames while a match is on screen
+ *   every 12 6 token  6 frames into every period, click the next token of the
+ *                     first seat, cycling through them
+ *   win quit          do an action once the win screen appears
+ *   9000 quit         close the game at frame 9000
+ *
+ * Events are keyed to frames, not time, so a run sends the same input
+ * however fast the machine draws. The rules still tick on their own clock
+ * unless the game runs in lockstep, one tick per frame; only then do a
+ * script and a dice seed always play the same match.
+ */
+class ScriptedInput : public InputProvider {
+public:
+    ScriptedInput();
+
+    /**
+     * @brief Reads a script file
+     * @return true if every line was understood; errors are printed
+     */
+    bool Load(const char* path);
+
+    /**
+     * @brief Reads a script from text
+     * @return true if every line was understood; errors are printed
+     */
+    bool Parse(const char* text);
+
+    void BeginFrame(long frame, int screen) override;
+    bool MousePressed() override { return pressed; }
+    bool MouseDown() override { return pressed; }
+    Vector2 MousePosition() override { return position; }
+    bool KeyPressed(int key) override;
+    bool CloseRequested() override { return closing; }
+
+private:
+    /** @brief What an event does */
+    enum Action { ACTION_KEY, ACTION_CLICK, ACTION_TOKEN, ACTION_QUIT };
+
+    /** @brief When an event fires */
+    enum Trigger { AT_FRAME, EVERY_FRAMES, ON_WIN };
+
+    /** @brief One line of the script */
+    struct Event {
+        Trigger trigger;    ///< When it fires
+        long frame;         ///< Frame for AT_FRAME, period for EVERY_FRAMES
+        long offset;        ///< Frame within the period for EVERY_FRAMES
+        Action action;      ///< What it does
+        int key;            ///< Key code for ACTION_KEY
+        Vector2 at;         ///< Logical position for ACTION_CLICK
+        bool fired;         ///< ON_WIN events fire once per win screen
+    };
+
+    /** @brief Applies an action to this frame's input */
+    void Fire(const Event& e);
+
+    /** @brief Logical centre of the next token of the first seat, cycling through them */
+    bool NextTokenPosition(Vector2& out);
+
+    static const int MAX_KEYS = 8;  ///< Key presses one frame can hold
+
+    std::vector<Event> events;  ///< The timeline, in file order
+    bool pressed;               ///< Left button pressed this frame
+    Vector2 position;           ///< Mouse position, kept between clicks
+    int keys[MAX_KEYS];         ///< Keys pressed this frame
+    int keyCount;               ///< Entries of keys in use
+    bool closing;               ///< A quit event has fired
+    int nextToken;              ///< Token the next token click goes to
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Metrics.h"
+#include <cstdio>
+#include <source_location>
+
+/**
+ * @brief Per-call-site contention statistics for the game mutexes
+ *
+ * Disabled by default; when enabled (MULTILUDO_LOCK_PROFILE set in the
+ * environment) every LockMutex/UnlockMutex pair is attributed to the source
+ * line that took the lock, and the locks already held by the thread are
+ * checked against the documented order mutex -> mutexDice -> mutexTurn.
+ * The report is printed at exit.
+ */
+
+/**
+ * @brief Turns profiling on or off; only call before any game thread starts
+ */
+void EnableLockProfiling(bool on);
+
+/**
+ * @brief True if lock acquisitions are being attributed to call sites
+ */
+bool LockProfilingEnabled();
+
+/**
+ * @brief Records an acquisition at a call site and checks the lock order
+ * @param id Lock that is now held by the calling thread
+ * @param waitNs Time spent acquiring it
+ * @param where Call site that took the lock
+ * @return Site index to pass to ProfileLockReleased
+ */
+int ProfileLockAcquired(MetricLockId id, uint64_t waitNs, const std::source_location& where);
+
+/**
+ * @brief Records the release of a lock taken at a profiled site
+ * @param id Lock being released by the calling thread
+ * @param site Index returned when it was acquired
+ * @param holdNs How long it was held
+ */
+void ProfileLockReleased(MetricLockId id, int site, uint64_t holdNs);
+
+/**
+ * @brief Writes the per-lock, per-site report and the observed lock order
+ */
+void WriteLockProfile(FILE* f);
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+/**
+ * @brief Bump allocator for everything that lives exactly as long as a match
+ *
+ * The board grid and all tokens are carved out of one buffer. The buffer is
+ * sized once for the largest match and kept, so later matches allocate
+ * nothing from the heap, and ending a match only rewinds a pointer. Only
+ * trivially destructible types may be placed in the arena.
+ */
+class MatchArena {
+public:
+    MatchArena();
+    ~MatchArena();
+
+    MatchArena(const MatchArena&) = delete;
+    MatchArena& operator=(const MatchArena&) = delete;
+
+    /**
+     * @brief Bytes a match with the given shape needs
+     * @param players Seats on the board
+     * @param tokens Tokens per player
+     */
+    static size_t MatchBytes(int players, int tokens);
+
+    /**
+     * @brief Makes sure the buffer holds at least the given size
+     * Only valid while the arena is empty (right after Reset)
+     * @param bytes Required capacity
+     * @return true if the capacity is available
+     */
+    bool Reserve(size_t bytes);
+
+    /**
+     * @brief Releases every allocation at once
+     */
+    void Reset() { used = 0; }
+
+    /**
+     * @brief Carves an aligned block out of the buffer
+     * @return Block, or nullptr if the arena is full
+     */
+    void* Allocate(size_t bytes, size_t align);
+
+    /**
+     * @brief Allocates and default-constructs an array
+     * @param n Number of elements
+     * @return First element, or nullptr if the arena is full
+     */
+    template <class T>
+    T* AllocArray(size_t n) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destructed");
+        void* p = Allocate(sizeof(T) * n, alignof(T));
+        if (p == nullptr) return nullptr;
+        T* first = static_cast<T*>(p);
+        for (size_t i = 0; i < n; i++) new (first + i) T();
+        return first;
+    }
+
+    size_t Used() const { return used; }
+    size_t Capacity() const { return capacity; }
+
+private:
+    char* buffer;       ///< Backing storage
+    size_t capacity;    ///< Size of the backing storage
+    size_t used;        ///< Bytes handed out since the last Reset
+};
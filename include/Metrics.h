@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <pthread.h>
+#include <source_location>
+
+/**
+ * @brief Monotonically increasing event count, safe to bump from any thread
+ */
+struct MetricCounter {
+    std::atomic<uint64_t> value{0};
+
+    void Add(uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t Get() const { return value.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Latency histogram with fixed buckets from 1 us to 1 s
+ *
+ * Every field is a relaxed atomic, so recording costs a few uncontended
+ * increments and never takes a lock.
+ */
+struct MetricHistogram {
+    static const int BUCKETS = 16;                  ///< Finite buckets; larger samples only count in +Inf
+    static const uint64_t BOUNDS_NS[BUCKETS];       ///< Upper bound of each bucket in nanoseconds
+
+    std::atomic<uint64_t> counts[BUCKETS + 1] = {};   ///< Per-bucket counts, last is +Inf
+    std::atomic<uint64_t> sumNs{0};                   ///< Sum of all samples
+    std::atomic<uint64_t> count{0};                   ///< Number of samples
+
+    /**
+     * @brief Records one sample
+     * @param ns Duration in nanoseconds
+     */
+    void Record(uint64_t ns);
+
+    /**
+     * @brief Upper bound of the bucket holding a quantile
+     * @param q Quantile between 0 and 1
+     * @return Bound in nanoseconds, 0 with no samples, UINT64_MAX past the last bucket
+     */
+    uint64_t Quantile(double q) const;
+};
+
+/** @brief The three global game mutexes from main.cpp */
+enum MetricLockId {
+    LOCK_GAME = 0,      ///< mutex
+    LOCK_DICE = 1,      ///< mutexDice
+    LOCK_TURN = 2,      ///< mutexTurn
+    LOCK_COUNT = 3
+};
+
+/**
+ * @brief Name of a game mutex as declared in main.cpp
+ */
+const char* MetricLockName(MetricLockId id);
+
+/**
+ * @brief Process-wide metrics registry
+ */
+struct Metrics {
+    MetricCounter turns;                        ///< Turns handed to a player
+    MetricCounter moves;                        ///< Token moves made
+    MetricCounter captures;                     ///< Tokens sent back to their yard
+    MetricCounter lockAcquisitions[LOCK_COUNT]; ///< Successful locks per mutex
+    MetricHistogram lockWait[LOCK_COUNT];       ///< Time spent waiting for each mutex
+    MetricHistogram lockHold[LOCK_COUNT];       ///< Time each mutex was held
+    MetricHistogram frameTime;                  ///< Time between presented frames
+    static const int MAX_INPUT_FRAMES = 8;      ///< Frames counted one by one; later results only count in the last
+
+    MetricHistogram inputLatency;               ///< Mouse press to the roll or move it triggered
+    MetricHistogram presentLatency;             ///< Roll or move to the end of the first frame showing it
+    MetricHistogram clickToPhoton;              ///< Mouse press to the end of the first frame showing its result
+    MetricCounter inputFrames[MAX_INPUT_FRAMES + 1];  ///< Presses by frames presented until their result showed
+    MetricCounter framesPresented;              ///< Frames the render loop has presented
+    std::atomic<uint64_t> inputAtNs{0};         ///< MetricsNowNs() of the last unhandled mouse press
+    std::atomic<uint64_t> inputFrame{0};        ///< framesPresented when that press was captured
+    std::atomic<uint64_t> handledAtNs{0};       ///< MetricsNowNs() of the last click result not yet on screen
+    std::atomic<uint64_t> handledInputNs{0};    ///< Capture time of the press that result belongs to
+    std::atomic<uint64_t> handledInputFrame{0}; ///< Capture frame of the press that result belongs to
+
+    /**
+     * @brief Writes every metric in Prometheus text exposition format
+     */
+    void WritePrometheus(FILE* f) const;
+
+    /**
+     * @brief Writes the metrics to a file, replacing it atomically
+     * @param path Destination file; a temporary file next to it is renamed over it
+     * @return true on success
+     */
+    bool Export(const char* path) const;
+};
+
+/** @brief Global metrics registry */
+extern Metrics metrics;
+
+/**
+ * @brief Monotonic clock in nanoseconds used by all metrics
+ */
+uint64_t MetricsNowNs();
+
+/**
+ * @brief Locks one of the game mutexes and records wait and hold times
+ * @param m Mutex to lock
+ * @param id Which game mutex it is
+ * @param where Call site, attributed when lock profiling is enabled
+ */
+void LockMutex(pthread_mutex_t* m, MetricLockId id,
+               std::source_location where = std::source_location::current());
+
+/**
+ * @brief Unlocks a mutex locked with LockMutex (or reported with NoteLocked)
+ */
+void UnlockMutex(pthread_mutex_t* m, MetricLockId id);
+
+/**
+ * @brief Reports a lock taken some other way, such as a timed lock
+ * @param id Which game mutex it is; the caller now holds it
+ * @param waitNs Time spent acquiring it
+ * @param where Call site, attributed when lock profiling is enabled
+ */
+void NoteLocked(MetricLockId id, uint64_t waitNs,
+                std::source_location where = std::source_location::current());
+
+/**
+ * @brief Starts timing a mouse press; call on the render thread when it is captured
+ */
+void NoteInputCaptured();
+
+/**
+ * @brief Records the input latency of the pending mouse press, if any
+ * Call when a roll or move triggered by a click has been applied
+ */
+void NoteInputHandled();
+
+/**
+ * @brief Counts a presented frame and records when a click result first reached the screen
+ * @param drawStartNs MetricsNowNs() before the frame read any game state; results applied
+ *                    later may be missing from it and wait for the next frame
+ * @param presentedNs MetricsNowNs() after EndDrawing returned
+ */
+void NoteFramePresented(uint64_t drawStartNs, uint64_t presentedNs);
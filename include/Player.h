@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Token.h"
+#include "TurnScheduler.h"
+#include "Rules.h"
 #include "raylib.h"
 #include <pthread.h>
 
@@ -12,12 +14,13 @@
  */
 class Player {
 public:
-    int id;                 ///< Unique identifier for the player (1-4)
-    Token* tokens;          ///< Array of tokens owned by this player
+    int id;                 ///< 0-based seat, which is also the board arm the player starts on
+    Token* tokens;          ///< This player's tokens, allocated from matchArena
     Color color;           ///< Player's color for visual representation
     bool completed;        ///< Flag indicating if player has won
     int score;            ///< Player's current score
     bool isPlaying;       ///< Flag indicating if player is active in game
+    bool isBot;           ///< Flag indicating the seat is played by the computer
 
     /**
      * @brief Default constructor
@@ -27,7 +30,7 @@ public:
 
     /**
      * @brief Destructor
-     * Cleans up player resources and token array
+     * Forgets the token array; its memory belongs to the match arena
      */
     ~Player();
 
@@ -35,17 +38,20 @@ public:
      * @brief Parameterized constructor
      * @param i Player ID
      * @param c Player color
-     * @param t Token texture
+     * @param sprite Frame of the token atlas
      */
-    Player(int i, Color c, Texture2D t);
+    Player(int i, Color c, int sprite);
 
     /**
      * @brief Configures player parameters
+     * Takes numTokens tokens from matchArena and places them in the yard of
+     * arm i of the active board
      * @param i Player ID to set
      * @param c Player color to set
-     * @param t Token texture to use
+     * @param sprite Frame of the token atlas the tokens are drawn with
+     * @param tint Tint for the token image
      */
-    void setPlayer(int i, Color c, Texture2D t);
+    void setPlayer(int i, Color c, int sprite, Color tint = WHITE);
 
     /**
      * @brief Verifies if player can continue playing
@@ -54,11 +60,18 @@ public:
     void checkPlayState();
 
     /**
-     * @brief Initiates player's turn
-     * Handles initial turn setup and validation
+     * @brief Per-frame bookkeeping for this player
+     * Sends captured tokens back to the yard and notices when every token
+     * has finished. Draws nothing and does no rules work
      */
     void Start();
 
+    /**
+     * @brief Queues this player's tokens for the frame's token batch
+     * @param batch Batch every token of the frame is drawn with
+     */
+    void draw(TokenBatch& batch);
+
     /**
      * @brief Enables tokens to move to home position
      * Validates and permits home square movement
@@ -73,13 +86,68 @@ public:
 
     /**
      * @brief Handles dice rolling mechanism
-     * Generates and validates dice roll result
+     * Polls for a click on the dice once and applies the roll
      */
     void rollDice();
 
+    /**
+     * @brief Copies matchState with this player to move
+     * @param s State to fill
+     */
+    void fillState(LudoState& s) const;
+
+    /**
+     * @brief Lists the legal moves for the die at the front of the queue
+     * @param out Destination buffer
+     * @param capacity Capacity of the destination buffer
+     * @return Number of legal moves written
+     */
+    int legalMoves(LudoMove* out, int capacity) const;
+
+    /**
+     * @brief Moves a token with the front die and consumes it
+     * @param i Index of the token, which must have a legal move
+     */
+    void moveToken(int i);
+
+    /**
+     * @brief Lets the computer pick and play a move for the front die
+     */
+    void botMove();
+
+    /**
+     * @brief Consumes the front die and passes the turn once no dice are left
+     */
+    void useDie();
+
+    /**
+     * @brief Records the front die as unusable and consumes it
+     */
+    void skipDie();
+
+    /**
+     * @brief Appends the use of the front die to matchRecord
+     * @param token Token it moves, or REPLAY_NO_MOVE
+     */
+    void recordDie(int token) const;
+
     /**
      * @brief Processes token movement
-     * Handles token selection and movement validation
+     * Skips the front die when no token can use it, otherwise moves
+     * the clicked token if the move is legal. The click is resolved
+     * through the board's hit index and spotTokens, so it costs the same
+     * however many tokens are on the board
      */
     void move();
+
+    /**
+     * @brief Turn loop for this player as a coroutine
+     * Parks while it is another player's turn and polls once per tick
+     * for dice and token clicks while it is this player's turn. Bot seats
+     * wait a short delay before each action so moves stay visible.
+     * Returns as soon as the scheduler's stop token fires
+     * @param scheduler Scheduler that resumes the coroutine
+     * @return Task owning the coroutine frame
+     */
+    TurnTask Play(TurnScheduler& scheduler);
 }; 
\ No newline at end of file
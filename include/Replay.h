@@ -0,0 +1,170 @@
+#pragma once
+
+#include "Rules.h"
+#include <cstdint>
+#include <vector>
+
+/** @brief Identifies a match replay file ("MLRP") */
+const uint32_t REPLAY_MAGIC = 0x50524C4D;
+
+/** @brief Replay file format version; version 1 files have no keyframes and are indexed on load */
+const uint16_t REPLAY_VERSION = 2;
+
+/** @brief Events between two keyframes, so a seek applies fewer than this many */
+const int REPLAY_KEYFRAME_INTERVAL = 32;
+
+/** @brief Token of an event whose die had no legal move and was skipped */
+const uint8_t REPLAY_NO_MOVE = 0xFF;
+
+/**
+ * @brief Header of a replay file
+ *
+ * The starting position follows it as one LudoState, then the events in
+ * the order they were played, then one ReplayIndexEntry per keyframe and
+ * the packed keyframes themselves, packedSize bytes each.
+ */
+struct ReplayHeader {
+    uint32_t magic;             ///< REPLAY_MAGIC
+    uint16_t version;           ///< REPLAY_VERSION
+    uint16_t stateSize;         ///< sizeof(LudoState) when written
+    uint32_t events;            ///< Number of events after the starting position
+    uint16_t keyframeInterval;  ///< Events between keyframes
+    uint16_t packedSize;        ///< Bytes of one packed keyframe
+};
+
+/**
+ * @brief Where a keyframe sits in the match
+ */
+struct ReplayIndexEntry {
+    uint32_t event;     ///< Events played before the keyframe's position
+    uint32_t turn;      ///< Turns started before it
+};
+
+/**
+ * @brief One die used in a match: the token it moved, or a skip
+ */
+struct ReplayEvent {
+    uint8_t player;     ///< 0-based seat that used the die
+    uint8_t die;        ///< Value of the die
+    uint8_t token;      ///< Token moved, or REPLAY_NO_MOVE
+    uint8_t queued;     ///< Dice in the seat's queue when this one was used, itself included
+};
+
+/**
+ * @brief Bytes of a packed position: one byte per token, the home mask and the turn
+ */
+inline int PackedStateSize(int players, int tokens) {
+    return players * tokens + 2;
+}
+
+/**
+ * @brief Packs the parts of a position that change during a match
+ * @param s Position
+ * @param out Receives PackedStateSize bytes
+ */
+void PackState(const LudoState& s, uint8_t* out);
+
+/**
+ * @brief Unpacks a position
+ * @param in Packed bytes
+ * @param s Position whose board, players and tokens are already set; the rest is overwritten
+ */
+void UnpackState(const uint8_t* in, LudoState& s);
+
+/**
+ * @brief Everything needed to play a match back move by move
+ *
+ * The game appends one event per die it uses; the position after any event
+ * is rebuilt by applying the events to the starting position with the
+ * rules engine, so nothing but the dice and the chosen tokens is stored.
+ *
+ * Every REPLAY_KEYFRAME_INTERVAL events a packed copy of the position is
+ * kept as a keyframe, so a seek starts from the nearest keyframe at or
+ * before the target and applies fewer than that many events, wherever in
+ * the match the target is. A turn is counted from the first die of a
+ * seat's turn that was used, so turns in which no die was played do not
+ * count.
+ */
+class MatchRecord {
+public:
+    /**
+     * @brief Forgets every event and starts recording from a position
+     * @param s Position the match continues from
+     */
+    void Start(const LudoState& s);
+
+    /**
+     * @brief Appends a used die
+     * @param player 0-based seat
+     * @param die Value of the die
+     * @param token Token moved, or REPLAY_NO_MOVE
+     * @param queued Dice in the seat's queue, this one included
+     */
+    void Add(int player, int die, int token, int queued);
+
+    /**
+     * @brief Writes the record to a file, with its keyframes
+     * @return true on success
+     */
+    bool Save(const char* path);
+
+    /**
+     * @brief Reads a record from a file
+     *
+     * Nothing is allocated or played before it is checked: the event count
+     * against the file size, and the starting position and every keyframe
+     * against the board (each token at most finished, the turn a seat, the
+     * home mask seats only), as ReadSnapshot checks a saved match.
+     *
+     * @return true if the file was read and its header, positions and index are valid
+     */
+    bool Load(const char* path);
+
+    /**
+     * @brief Plays the events once and keeps a keyframe every REPLAY_KEYFRAME_INTERVAL
+     * @return false if an event is not legal in its position
+     */
+    bool BuildIndex();
+
+    /**
+     * @brief Rebuilds the position after a number of events
+     * @param event Events to play, 0 to events.size()
+     * @param out Receives the position
+     * @return false if event is out of range or the index is missing
+     */
+    bool Seek(int event, LudoState& out) const;
+
+    /**
+     * @brief Checks if an event is the first of a turn
+     */
+    bool StartsTurn(int event) const;
+
+    /**
+     * @brief 1-based turn an event belongs to
+     */
+    int TurnOf(int event) const;
+
+    /**
+     * @brief First event of a 1-based turn, or events.size() past the last turn
+     */
+    int TurnStart(int turn) const;
+
+    /**
+     * @brief Turns in the record
+     */
+    int TurnCount() const;
+
+    LudoState start;                        ///< Position before the first event
+    std::vector<ReplayEvent> events;        ///< Dice in the order they were used
+    std::vector<ReplayIndexEntry> index;    ///< One entry per keyframe, in match order
+    std::vector<uint8_t> keyframes;         ///< Packed positions, one per index entry
+};
+
+/**
+ * @brief Plays one event on a position
+ * @param s Position before the event; updated in place
+ * @param e Event to play
+ * @param move Receives the move played (unchanged for a skip), or nullptr
+ * @return false if the event is not legal in the position
+ */
+bool ApplyReplayEvent(LudoState& s, const ReplayEvent& e, LudoMove* move = nullptr);
@@ -0,0 +1,280 @@
+#pragma once
+
+#include "BoardGeometry.h"
+#include <cstdint>
+#include <tuple>
+
+/** @brief Maximum number of players the rules engine handles */
+const int RULES_MAX_PLAYERS = BOARD_MAX_ARMS;
+
+/** @brief Players on the classic board, the only one the tablebase and batch engine play */
+const int CLASSIC_PLAYERS = 4;
+
+/** @brief Maximum number of tokens per player the rules engine handles */
+const int RULES_MAX_TOKENS = 8;
+
+/** @brief Tokens per player in the classic game, the most the batch engine plays */
+const int CLASSIC_TOKENS = 4;
+
+static_assert(RULES_MAX_TOKENS <= BOARD_YARD_SLOTS, "every token needs a yard spot");
+static_assert(RULES_MAX_PLAYERS <= 8, "LudoState::cells holds a bit per seat in a byte");
+
+/** @brief Maximum number of dice a single turn can queue (three sixes forfeit) */
+const int RULES_MAX_DICE = 3;
+
+/** @brief Number of cells on the shared outer track of the classic board */
+const int TRACK_LENGTH = 52;
+
+/** @brief Number of track cells in one arm of the classic board */
+const int ARM_LENGTH = 13;
+
+/**
+ * @brief House rules of the classic game
+ *
+ * A rule variant is a struct with these constants. The engine functions take
+ * it as a template parameter, so every variant compiles to its own code with
+ * no runtime checks of the configuration.
+ */
+struct ClassicRules {
+    static constexpr const char* NAME = "classic";
+    static constexpr bool TRIPLE_SIX_FORFEITS = true;    ///< A third six forfeits the turn; otherwise it is played and ends the turn
+    static constexpr bool CAPTURE_TO_ENTER_HOME = true;  ///< A player must capture before entering its home column
+    static constexpr bool EXACT_FINISH = true;           ///< Finishing needs the exact roll; otherwise overshooting finishes
+    static constexpr bool SAFE_SQUARES = true;           ///< The board's safe squares protect tokens from capture
+};
+
+/** @brief Faster games: no capture needed to go home and no exact finish */
+struct QuickRules : ClassicRules {
+    static constexpr const char* NAME = "quick";
+    static constexpr bool CAPTURE_TO_ENTER_HOME = false;
+    static constexpr bool EXACT_FINISH = false;
+};
+
+/** @brief No safe squares, and a third six is played instead of forfeited */
+struct CutthroatRules : ClassicRules {
+    static constexpr const char* NAME = "cutthroat";
+    static constexpr bool TRIPLE_SIX_FORFEITS = false;
+    static constexpr bool SAFE_SQUARES = false;
+};
+
+/**
+ * @brief Applies X to every rule variant the engine is instantiated for
+ * Adding a variant here makes it available to the rules engine and ludo_sim
+ */
+#define RULE_VARIANTS(X) X(ClassicRules) X(QuickRules) X(CutthroatRules)
+
+/** @brief Rules played by the game window and its computer opponents */
+typedef ClassicRules GameRules;
+
+/**
+ * @brief Packed token positions on the classic board, relative to the owning player
+ *
+ * 0 is the yard, 1..52 are track cells counted from the player's start
+ * square (51 is the tip of the player's own arm), 53..57 are the home
+ * column and 58 is finished. Other boards keep the yard and start and take
+ * the rest from BoardGeometry (tip, homeFirst, finished).
+ */
+enum TokenPos {
+    POS_YARD = 0,
+    POS_START = 1,
+    POS_TIP = 51,
+    POS_HOME_FIRST = 53,
+    POS_FINISHED = 58
+};
+
+/** @brief Flags describing what a move does */
+enum MoveFlags {
+    MOVE_ENTER = 1,      ///< Token leaves the yard
+    MOVE_CAPTURE = 2,    ///< Token lands on at least one capturable opponent
+    MOVE_FINISH = 4,     ///< Token reaches the end of the home column
+    MOVE_SAFE = 8        ///< Token lands on a safe square
+};
+
+/**
+ * @brief Compact board state used by the rules engine
+ *
+ * Plain data with no pointers, so it can be copied, hashed and stored freely.
+ * Besides the token positions it keeps which seats occupy every track cell,
+ * so spotting a capture is one lookup however many tokens are in play. Code
+ * that writes pos directly must call IndexCells afterwards.
+ */
+struct LudoState {
+    uint8_t pos[RULES_MAX_PLAYERS][RULES_MAX_TOKENS];  ///< Relative position of every token
+    uint8_t cells[BOARD_MAX_TRACK];                    ///< Bit per seat with a token on each track cell
+    uint8_t homeMask;       ///< Bit per player: has captured and may enter home
+    uint8_t numTokens;      ///< Tokens per player in this match
+    uint8_t numPlayers;     ///< Seats on the board
+    uint8_t board;          ///< Registry id of the BoardGeometry
+    uint8_t turn;           ///< 0-based seat to move
+};
+
+/**
+ * @brief One legal (token, die) choice
+ */
+struct LudoMove {
+    uint8_t token;      ///< Index of the token to move
+    uint8_t die;        ///< Index of the die in the pending dice queue
+    uint8_t from;       ///< Position before the move
+    uint8_t to;         ///< Position after the move
+    uint8_t flags;      ///< Combination of MoveFlags
+};
+
+/**
+ * @brief One possible dice outcome of a whole turn
+ *
+ * A six grants another roll and a third six forfeits the turn, so a turn
+ * rolls one to three dice. A forfeited turn has count 0.
+ */
+struct TurnDice {
+    int dice[RULES_MAX_DICE];  ///< Dice in the order they are used
+    int count;                 ///< Number of dice to play (0 when forfeited)
+    double prob;               ///< Probability of this outcome
+};
+
+/** @brief Number of distinct dice outcomes of a turn */
+const int TURN_DICE_COUNT = 16;
+
+/** @brief All dice outcomes of a turn with their probabilities (ClassicRules) */
+extern const TurnDice TURN_DICE[TURN_DICE_COUNT];
+
+/**
+ * @brief Resets a state to the start of a match
+ * @param s State to reset
+ * @param tokens Tokens per player
+ * @param firstTurn 0-based seat that moves first
+ * @param board Registry id of the board; one player per arm
+ */
+void InitState(LudoState& s, int tokens, int firstTurn, int board = BOARD_CLASSIC);
+
+/**
+ * @brief Moves one token, keeping the cell occupancy up to date
+ *
+ * Costs a scan of the owner's tokens only, to see whether the cell it
+ * leaves is now empty of them. Does not capture; see ApplyMove.
+ *
+ * @param s State to update
+ * @param player 0-based owner of the token
+ * @param token Index of the token
+ * @param pos New relative position
+ */
+void PlaceToken(LudoState& s, int player, int token, int pos);
+
+/**
+ * @brief Rebuilds the cell occupancy from the token positions
+ * @param s State whose pos entries were written directly
+ */
+void IndexCells(LudoState& s);
+
+/**
+ * @brief Maps a relative position to its absolute track cell
+ * @param player 0-based owner of the token
+ * @param pos Relative position
+ * @param board Registry id of the board
+ * @return Track cell, or -1 for yard, home column and finished
+ */
+int TrackCell(int player, int pos, int board = BOARD_CLASSIC);
+
+/**
+ * @brief Checks if an absolute track cell is a safe square
+ * @tparam R Rule variant
+ * @param g Board the cell is on
+ * @param cell Track cell, or -1
+ * @return true if tokens cannot be captured there
+ */
+template <class R = ClassicRules>
+bool IsSafeCell(const BoardGeometry& g, int cell) {
+    return R::SAFE_SQUARES && g.IsSafe(cell);
+}
+
+/**
+ * @brief Computes where a token ends up after moving by one die
+ * @tparam R Rule variant
+ * @param g Board being played
+ * @param pos Current relative position
+ * @param die Die value 1..6
+ * @param canGoHome Whether the owner may enter the home column
+ * @return New relative position, or -1 if the move is illegal
+ */
+template <class R = ClassicRules>
+int MoveTarget(const BoardGeometry& g, int pos, int die, bool canGoHome);
+
+/**
+ * @brief Enumerates all legal (token, die) choices for a player
+ *
+ * Writes into a caller-provided buffer and never allocates. Zero dice
+ * (unused queue slots) are skipped and repeated die values are only
+ * listed once, for their first index.
+ *
+ * @tparam R Rule variant
+ * @param s Current state
+ * @param player 0-based player to move
+ * @param dice Pending dice queue
+ * @param numDice Number of entries in the queue
+ * @param out Destination buffer
+ * @param capacity Capacity of the destination buffer
+ * @return Number of moves written
+ */
+template <class R = ClassicRules>
+int GenerateMoves(const LudoState& s, int player, const int* dice, int numDice, LudoMove* out, int capacity);
+
+/**
+ * @brief Applies a move, sending captured opponents back to their yards
+ * @tparam R Rule variant
+ * @param s State to update
+ * @param player 0-based player making the move
+ * @param m Move previously returned by GenerateMoves
+ * @return Number of opponent tokens captured
+ */
+template <class R = ClassicRules>
+int ApplyMove(LudoState& s, int player, const LudoMove& m);
+
+/**
+ * @brief Converts a board grid position to a relative position
+ * @param player 0-based owner of the token
+ * @param g Grid position (arm, row, column); negative for the yard
+ * @param board Registry id of the board
+ * @return Relative position
+ */
+int GridToPos(int player, const std::tuple<int, int, int>& g, int board = BOARD_CLASSIC);
+
+/**
+ * @brief Converts a relative position back to a board grid position
+ * @param player 0-based owner of the token
+ * @param pos Relative position
+ * @param board Registry id of the board
+ * @return Grid position (arm, row, column); (-1,-1,-1) for the yard
+ */
+std::tuple<int, int, int> PosToGrid(int player, int pos, int board = BOARD_CLASSIC);
+
+/**
+ * @brief Finds the best value reachable by playing a dice queue in order
+ *
+ * Dice are used front to back as in the game; a die no token can use is
+ * skipped. Every sequence of choices is explored and the leaf evaluation
+ * of the resulting state is maximized.
+ *
+ * @tparam R Rule variant
+ * @param s State before the first die
+ * @param player 0-based player to move
+ * @param dice Dice queue
+ * @param numDice Number of dice left in the queue
+ * @param leaf Callable returning the value of a state after the last die
+ * @return Best leaf value over all legal choice sequences
+ */
+template <class R = ClassicRules, class Leaf>
+double BestTurnValue(const LudoState& s, int player, const int* dice, int numDice, Leaf& leaf) {
+    if (numDice == 0) return leaf(s);
+
+    LudoMove moves[RULES_MAX_TOKENS];
+    int count = GenerateMoves<R>(s, player, dice, 1, moves, RULES_MAX_TOKENS);
+    if (count == 0) return BestTurnValue<R>(s, player, dice + 1, numDice - 1, leaf);
+
+    double best = -1e30;
+    for (int i = 0; i < count; i++) {
+        LudoState next = s;
+        ApplyMove<R>(next, player, moves[i]);
+        double v = BestTurnValue<R>(next, player, dice + 1, numDice - 1, leaf);
+        if (v > best) best = v;
+    }
+    return best;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "TurnScheduler.h"
+#include "Utils.h"
+#include <pthread.h>
+#include <stop_token>
+
+/**
+ * @brief Work of one logic tick
+ * Called on the scheduler thread with the game mutex held
+ * @param context Owner passed to the SchedulerThread
+ * @param input Click latched since the previous tick, if any
+ */
+typedef void (*LogicTick)(void* context, const TickInput& input);
+
+/**
+ * @brief Thread that ticks a TurnScheduler at a fixed rate
+ *
+ * Ticks run at tickRate whatever the frame rate. A thread that falls behind
+ * runs at most MAX_CATCHUP_TICKS ticks back to back and drops the rest, so a
+ * stall never turns into a burst of bot moves. Every blocking wait is bounded
+ * so a stop request is seen within STOP_POLL_MS.
+ *
+ * Stop never waits longer than SHUTDOWN_DEADLINE_MS. A thread that misses
+ * the deadline stays joinable: Join, which the destructor also calls, makes
+ * the final blocking wait, so nothing the thread uses is freed under it.
+ *
+ * In lockstep no thread is created: the owner calls Step once per frame, so
+ * the number of ticks between two inputs depends only on the frames drawn.
+ */
+class SchedulerThread {
+public:
+    static const int STOP_POLL_MS = 50;             ///< Longest the thread blocks without checking for stop
+    static const int SHUTDOWN_DEADLINE_MS = 500;    ///< Longest Stop waits for the thread
+    static const int LOGIC_TICK_RATE = 60;          ///< Default logic ticks per second
+    static const int MAX_CATCHUP_TICKS = 5;         ///< Most ticks run back to back after falling behind
+
+    /**
+     * @param scheduler Scheduler whose coroutines the ticks resume
+     * @param gameMutex Mutex held for every tick
+     * @param tick Work of one tick
+     * @param context Passed to tick
+     */
+    SchedulerThread(TurnScheduler& scheduler, pthread_mutex_t* gameMutex, LogicTick tick, void* context);
+
+    /**
+     * @brief Joins a thread still running, however long it takes
+     */
+    ~SchedulerThread();
+
+    SchedulerThread(const SchedulerThread&) = delete;
+    SchedulerThread& operator=(const SchedulerThread&) = delete;
+
+    /**
+     * @brief Creates the thread with a fresh stop token for the scheduler
+     * @return true if the thread was created
+     */
+    bool Start();
+
+    /**
+     * @brief Requests a cooperative stop and waits at most SHUTDOWN_DEADLINE_MS
+     * @param elapsedMs Receives how long the wait took, or nullptr
+     * @return true if the thread has exited; false leaves it joinable
+     */
+    bool Stop(double* elapsedMs = nullptr);
+
+    /**
+     * @brief Requests a stop and waits for the thread without a deadline
+     */
+    void Join();
+
+    /**
+     * @brief Checks if a thread exists that has not been joined yet
+     */
+    bool Running() const { return running; }
+
+    /**
+     * @brief Runs one tick on the calling thread; only used in lockstep
+     */
+    void Step();
+
+    /**
+     * @brief Hands a click to the next logic tick
+     * A click waits for the next tick; two clicks within one tick keep the later
+     */
+    void Latch(int x, int y);
+
+    /**
+     * @brief Takes the latched click, so it is seen by one tick only
+     */
+    TickInput Take();
+
+    int tickRate;                       ///< Logic ticks per second, independent of the frame rate
+    bool lockstep;                      ///< No thread: the owner calls Step once per frame
+
+private:
+    static void* ThreadMain(void* args);
+    void Loop();
+    void Finish();
+    void RequestStop();
+
+    TurnScheduler& scheduler;           ///< Coroutines resumed by the ticks
+    pthread_mutex_t* gameMutex;         ///< Held for every tick
+    LogicTick tick;                     ///< Work of one tick
+    void* context;                      ///< Passed to tick
+    pthread_t thread;                   ///< Thread running Loop
+    bool running;                       ///< True from Start until the thread is joined, or stopped in lockstep
+    std::stop_source stopSource;        ///< Asks the thread and all coroutines to finish
+    pthread_mutex_t inputMutex;         ///< Protects pendingInput
+    pthread_cond_t stopCond;            ///< Signalled to wake the thread early when stopping
+    TickInput pendingInput;             ///< Click latched for the next tick
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "Rules.h"
+#include "Stats.h"
+#include <cstdint>
+
+class Evaluator;
+
+/** @brief Turn limit after which a classic game (4 seats, 4 tokens) is abandoned */
+const int SIM_MAX_TURNS = 20000;
+
+/** @brief Game-length histogram bucket width for a classic game, in turns */
+const int SIM_LENGTH_BUCKET = 10;
+
+/**
+ * @brief How much longer games on a board run than classic ones, at least 1
+ *
+ * Grows with arms^2 * finished * tokens: every seat adds a turn to each
+ * round and a seat that has to finish. Lengths grow a little faster still,
+ * as crowded tracks capture more, so the ratio is raised to a power fitted
+ * to greedy self-play (classic median 507 turns, 8 arms with 8 tokens 17545).
+ */
+double SimLengthScale(int board, int tokens);
+
+/** @brief Turn limit after which a game on a board is abandoned; SIM_MAX_TURNS scaled */
+int SimMaxTurns(int board, int tokens);
+
+/** @brief Game-length histogram bucket width for a board; SIM_LENGTH_BUCKET scaled */
+int SimLengthBucket(int board, int tokens);
+
+/**
+ * @brief Small, fast random generator for simulations (splitmix64)
+ *
+ * Every simulation thread owns one, seeded differently, so runs are
+ * reproducible and threads never share generator state.
+ */
+struct SimRng {
+    uint64_t state;
+
+    explicit SimRng(uint64_t seed) : state(seed) {}
+
+    uint64_t Next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /** @brief Uniform integer in [0, n) */
+    int Below(int n) { return (int)(((Next() >> 32) * (uint64_t)n) >> 32); }
+
+    /** @brief Roll of a six-sided die */
+    int Die() { return Below(6) + 1; }
+};
+
+/**
+ * @brief Seed of one game in a run, so results do not depend on threading
+ * @param seed Base seed of the run
+ * @param game Index of the game within the run
+ */
+inline uint64_t SimGameSeed(uint64_t seed, uint64_t game) {
+    // Hash the pair: seeds one golden-ratio step apart would give shifted copies of one stream
+    uint64_t z = seed * 0x100000001B3ULL ^ (game + 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 33)) * 0xFF51AFD7ED558CCDULL;
+    z = (z ^ (z >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+    return z ^ (z >> 33);
+}
+
+/**
+ * @brief Random-permutation turn order, as dealt by GenerateTurns/getTurn
+ */
+struct SimTurnOrder {
+    int order[RULES_MAX_PLAYERS];   ///< Seats of the current round; taken from the back
+    int players;                    ///< Seats in the game
+    int left;                       ///< Seats still to play this round
+
+    explicit SimTurnOrder(int seats = CLASSIC_PLAYERS) : players(seats), left(0) {}
+
+    /** @brief Deals a new round */
+    void Deal(SimRng& rng);
+
+    /**
+     * @brief Takes the next seat that has not finished
+     * @param done Finished flag per seat
+     */
+    int Next(SimRng& rng, const bool* done);
+
+    /** @brief Checks if a seat still has a turn in the current round */
+    bool Pending(int seat) const;
+};
+
+/**
+ * @brief Chooses a move for the die at the front of a queue
+ *
+ * Same contract as BotChooseMove, with a generator for policies that
+ * need randomness.
+ *
+ * @return true if a move was chosen, false if the front die must be skipped
+ */
+typedef bool (*SimPolicy)(const LudoState& s, int player, const int* dice, int numDice,
+                          int phase, SimRng& rng, LudoMove& out);
+
+/** @brief The in-game computer opponent (tablebase endgames, greedy otherwise); plays GameRules */
+bool SimBotPolicy(const LudoState& s, int player, const int* dice, int numDice,
+                  int phase, SimRng& rng, LudoMove& out);
+
+/** @brief Always plays the move with the highest GreedyScore (first on ties) */
+template <class R = ClassicRules>
+bool SimGreedyPolicy(const LudoState& s, int player, const int* dice, int numDice,
+                     int phase, SimRng& rng, LudoMove& out);
+
+/** @brief Picks uniformly among the legal moves */
+template <class R = ClassicRules>
+bool SimRandomPolicy(const LudoState& s, int player, const int* dice, int numDice,
+                     int phase, SimRng& rng, LudoMove& out);
+
+/**
+ * @brief Checks if every token of a player has finished
+ */
+bool SimAllFinished(const LudoState& s, int player);
+
+/**
+ * @brief Evaluator's estimate for a player, 1 once every token has finished
+ */
+float SimPositionValue(const Evaluator& e, const LudoState& s, int player);
+
+/**
+ * @brief Plays a queue of dice for a seat with the greedy heuristic; plays GameRules
+ */
+void SimGreedyTurn(LudoState& s, int player, const int* dice, int numDice);
+
+/**
+ * @brief Outcome of one simulated game
+ */
+struct SimResult {
+    int places[RULES_MAX_PLAYERS];  ///< Seats in finishing order
+    int turns;                      ///< Turns played
+    bool finished;                  ///< false if the turn limit was hit
+};
+
+/**
+ * @brief Plays one game from the opening position, one seat per board arm
+ *
+ * Follows the game's rules: turns are dealt in random permutations of
+ * the seats, a six rolls again, a third six forfeits the turn (or is
+ * played, depending on the variant), and the dice are used front to back.
+ * The game ends when one seat is left, or is abandoned after SimMaxTurns.
+ *
+ * @tparam R Rule variant; the policies must play the same variant
+ * @param tokens Tokens per player
+ * @param policies Policy for each seat
+ * @param rng Generator for dice and turn order
+ * @param stats Aggregates to update, or nullptr
+ * @param board Registry id of the board
+ * @param policyRngs One generator per seat for its policy's decisions, or
+ *                   nullptr to draw them from rng. With separate generators,
+ *                   games with the same rng seed roll the same dice and deal
+ *                   the same turns whatever the policies decide
+ * @return Finishing order and length
+ */
+template <class R = ClassicRules>
+SimResult SimulateGame(int tokens, const SimPolicy* policies, SimRng& rng, SimStats* stats,
+                       int board = BOARD_CLASSIC, SimRng* policyRngs = nullptr);
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class Game;
+
+/** @brief Magic number at the start of every snapshot ("MLSN" in little-endian) */
+const uint32_t SNAPSHOT_MAGIC = 0x4E534C4D;
+
+/** @brief Current snapshot format version, bumped on every layout change */
+const uint16_t SNAPSHOT_VERSION = 2;
+
+/** @brief Size in bytes of the fixed snapshot header */
+const size_t SNAPSHOT_HEADER_SIZE = 16;
+
+/**
+ * @brief Computes the exact size of a snapshot for a given match shape
+ * @param players Number of seats on the board
+ * @param tokens Number of tokens per player
+ * @return Number of bytes WriteSnapshot needs for a match of that shape
+ */
+size_t SnapshotSize(int players, int tokens);
+
+/**
+ * @brief Serializes an in-progress match into a caller-provided buffer
+ *
+ * The format is a fixed little-endian layout with no allocation, so a server
+ * can checkpoint many matches into preallocated memory. The caller holds
+ * the game mutex, so no tick changes the match while it is captured.
+ *
+ * @param game Game whose players and global state are captured
+ * @param buffer Destination buffer
+ * @param capacity Size of the destination buffer in bytes
+ * @return Number of bytes written, or 0 if the buffer is too small
+ */
+size_t WriteSnapshot(const Game& game, uint8_t* buffer, size_t capacity);
+
+/**
+ * @brief Restores a match from a snapshot buffer into a game
+ *
+ * Validates magic, version, size and checksum, then decodes the whole
+ * payload and checks every field against the board and token count before
+ * touching any state. Only a fully valid snapshot sets up the players and
+ * overwrites them with the stored values.
+ *
+ * @param game Game to restore into (textures must already be loaded)
+ * @param buffer Source buffer
+ * @param size Size of the source buffer in bytes
+ * @return true if the snapshot was valid and applied, false otherwise
+ */
+bool ReadSnapshot(Game& game, const uint8_t* buffer, size_t size);
+
+/**
+ * @brief Writes a snapshot of the match to a file
+ * The match is captured under the game mutex, like ReadSnapshot restores it;
+ * the file is written after the lock is released
+ * @param game Game to save
+ * @param path Destination file path
+ * @return true on success, false otherwise
+ */
+bool SaveSnapshot(const Game& game, const char* path);
+
+/**
+ * @brief Loads a snapshot file into a game
+ * @param game Game to restore into
+ * @param path Source file path
+ * @return true on success, false otherwise
+ */
+bool LoadSnapshot(Game& game, const char* path);
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Rules.h"
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * @brief Plain event counter
+ *
+ * Owned by one thread while counting and merged with others afterwards,
+ * so it needs no atomics.
+ */
+struct Counter {
+    uint64_t value = 0;
+
+    void Add(uint64_t n = 1) { value += n; }
+    void Merge(const Counter& other) { value += other.value; }
+};
+
+/**
+ * @brief Histogram with a fixed number of equal-width buckets
+ *
+ * Values past the last bucket are counted in an overflow bucket, so memory
+ * stays constant however many samples are added.
+ */
+class FixedHistogram {
+public:
+    static const int BUCKETS = 128; ///< Number of regular buckets
+
+    /**
+     * @brief Creates an empty histogram
+     * @param bucketWidth Width of each bucket; bucket i covers [i*w, (i+1)*w)
+     */
+    explicit FixedHistogram(int bucketWidth = 1);
+
+    /**
+     * @brief Adds one sample
+     * @param v Non-negative sample value
+     */
+    void Add(int v);
+
+    /**
+     * @brief Adds another histogram with the same bucket width
+     */
+    void Merge(const FixedHistogram& other);
+
+    int width;                      ///< Width of each bucket
+    uint64_t counts[BUCKETS];       ///< Samples per bucket
+    uint64_t overflow;              ///< Samples at or past BUCKETS * width
+};
+
+/**
+ * @brief Mergeable quantile sketch with bounded relative error
+ *
+ * Positive samples are counted in logarithmically spaced buckets, so a
+ * quantile is accurate to about 1% of its value. Memory is fixed and two
+ * sketches merge by adding bucket counts.
+ */
+class QuantileSketch {
+public:
+    static const int BUCKETS = 1024;   ///< Covers values from 1 to about 6e8
+
+    QuantileSketch();
+
+    /**
+     * @brief Adds one sample
+     * @param v Sample value; values below 1 are counted as 1
+     */
+    void Add(double v);
+
+    /**
+     * @brief Adds all samples of another sketch
+     */
+    void Merge(const QuantileSketch& other);
+
+    /**
+     * @brief Estimates a quantile
+     * @param q Quantile in [0, 1]
+     * @return Estimated value, or 0 if the sketch is empty
+     */
+    double Quantile(double q) const;
+
+    uint64_t count;                 ///< Number of samples
+    uint64_t counts[BUCKETS];       ///< Samples per logarithmic bucket
+};
+
+/**
+ * @brief Everything recorded about a batch of simulated games
+ *
+ * Each simulation thread fills its own instance; instances are merged
+ * once the threads have finished.
+ */
+struct SimStats {
+    Counter games;                                          ///< Games played to the end
+    Counter unfinished;                                     ///< Games stopped at the turn limit
+    Counter turns;                                          ///< Turns played
+    Counter finishedTurns;                                  ///< Turns played in games played to the end
+    Counter moves;                                          ///< Token moves made
+    Counter captures;                                       ///< Opponent tokens sent home
+    Counter tripleSixes;                                    ///< Turns forfeited by three sixes
+    Counter seatWins[RULES_MAX_PLAYERS];                    ///< First places per seat
+    Counter seatPlaces[RULES_MAX_PLAYERS][RULES_MAX_PLAYERS];  ///< Finishing place counts per seat
+    Counter capturesBySquare[BOARD_MAX_TRACK];              ///< Captures per absolute track cell
+    int players;                                            ///< Seats reported, from the board played
+    int trackCells;                                         ///< Track cells reported, from the board played
+    FixedHistogram gameLength;                              ///< Turns per game, in equal-width buckets
+    QuantileSketch gameLengthSketch;                        ///< Turns per game, for quantiles
+
+    /**
+     * @param lengthBucket Game-length bucket width in turns; wider for boards with longer games
+     */
+    explicit SimStats(int lengthBucket = 10);
+
+    /**
+     * @brief Adds the counts of another instance
+     */
+    void Merge(const SimStats& other);
+
+    /**
+     * @brief Writes all aggregates as one JSON object
+     */
+    void WriteJson(FILE* f) const;
+
+    /**
+     * @brief Writes all aggregates as metric,key,value rows
+     */
+    void WriteCsv(FILE* f) const;
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "Rules.h"
+#include <cstddef>
+#include <cstdint>
+
+/** @brief Magic number at the start of every tablebase file ("MLTB" in little-endian) */
+const uint32_t TABLEBASE_MAGIC = 0x42544C4D;
+
+/** @brief Current tablebase format version */
+const uint16_t TABLEBASE_VERSION = 1;
+
+/** @brief Largest token count a tablebase is generated for */
+const int TABLEBASE_MAX_TOKENS = 2;
+
+/** @brief Largest stored probability; values are quantized to 1/65535 */
+const int TABLEBASE_SCALE = 65535;
+
+/**
+ * @brief Where the side to move sits in the current round of the turn order
+ *
+ * Turns are dealt in random permutations of the seats, so with two players
+ * left the side to move is either the first of the two in this round (the
+ * opponent moves next for sure) or the second (the next round may start
+ * with either player).
+ */
+enum EndgamePhase {
+    PHASE_FIRST = 0,
+    PHASE_SECOND = 1
+};
+
+/**
+ * @brief Fixed header at the start of a tablebase file
+ *
+ * The quantized uint16_t values follow at dataOffset and are indexed
+ * directly by EndgameEntryIndex, so a mapped file needs no parsing.
+ */
+struct TablebaseHeader {
+    uint32_t magic;         ///< TABLEBASE_MAGIC
+    uint16_t version;       ///< TABLEBASE_VERSION
+    uint8_t numTokens;      ///< Tokens per player covered by the table
+    uint8_t reserved;       ///< Always zero
+    uint32_t configCount;   ///< Number of per-player token configurations
+    uint32_t dataOffset;    ///< Byte offset of the value array
+    uint64_t entryCount;    ///< Number of uint16_t values
+};
+
+/**
+ * @brief Number of distinct token configurations of one player
+ *
+ * A configuration is the multiset of token positions plus whether the
+ * player may enter the home column.
+ *
+ * @param tokens Tokens per player (1 or 2)
+ * @return Number of configurations
+ */
+int EndgameConfigCount(int tokens);
+
+/**
+ * @brief Packs one player's tokens into a configuration index
+ * @param pos Token positions (order does not matter)
+ * @param tokens Number of tokens
+ * @param canGoHome Whether the player may enter the home column
+ * @return Configuration index, or -1 if the positions are impossible
+ */
+int EndgameConfigIndex(const uint8_t* pos, int tokens, bool canGoHome);
+
+/**
+ * @brief Unpacks a configuration index
+ * @param index Configuration index
+ * @param tokens Number of tokens
+ * @param pos Receives the token positions in ascending order
+ * @param canGoHome Receives whether the player may enter the home column
+ */
+void EndgameConfigDecode(int index, int tokens, uint8_t* pos, bool& canGoHome);
+
+/**
+ * @brief Position of a value in the table
+ * @param configCount Configurations per player
+ * @param offset Seats from the side to move to the opponent (1..3)
+ * @param phase EndgamePhase of the side to move
+ * @param mover Configuration of the side to move
+ * @param opponent Configuration of the opponent
+ * @return Index into the value array
+ */
+uint64_t EndgameEntryIndex(int configCount, int offset, int phase, int mover, int opponent);
+
+/**
+ * @brief Value to the side that just moved, from the values of the next turn
+ *
+ * Shared by the generator (reading its working array) and the mapped table.
+ *
+ * @param value Callable (offset, phase, mover, opponent) -> win probability of that mover
+ * @param moverCfg Configuration of the player who just moved
+ * @param opponentCfg Configuration of the opponent
+ * @param offset Seats from the player who just moved to the opponent
+ * @param phase EndgamePhase the player had during the turn
+ * @return Win probability of the player who just moved
+ */
+template <class Value>
+double EndgameContinuation(const Value& value, int moverCfg, int opponentCfg, int offset, int phase) {
+    int back = CLASSIC_PLAYERS - offset;
+    if (phase == PHASE_FIRST) {
+        // The opponent is the second of the two in this round
+        return 1.0 - value(back, PHASE_SECOND, opponentCfg, moverCfg);
+    }
+    // A new round starts with either player at equal odds
+    return 0.5 * value(offset, PHASE_FIRST, moverCfg, opponentCfg) +
+           0.5 * (1.0 - value(back, PHASE_FIRST, opponentCfg, moverCfg));
+}
+
+/**
+ * @brief Read-only, memory-mapped endgame table for two remaining players
+ *
+ * Stores the probability that the side to move finishes before its
+ * opponent under optimal play by both.
+ */
+class Tablebase {
+public:
+    Tablebase();
+    ~Tablebase();
+
+    /**
+     * @brief Maps a tablebase file into memory
+     * @param path File to map
+     * @return true if the file was mapped and its header is valid
+     */
+    bool Open(const char* path);
+
+    /**
+     * @brief Unmaps the file
+     */
+    void Close();
+
+    /**
+     * @brief Checks if a table is mapped
+     */
+    bool IsOpen() const { return data != nullptr; }
+
+    /**
+     * @brief Tokens per player covered by the mapped table
+     */
+    int Tokens() const { return numTokens; }
+
+    /**
+     * @brief Reads a stored value
+     * @return Win probability of the side to move
+     */
+    float Lookup(int offset, int phase, int mover, int opponent) const;
+
+    /**
+     * @brief Win probability of a player who has just finished a turn
+     * @param s State after the turn
+     * @param mover Player who just moved
+     * @param opponent The only other player still in the game
+     * @param phase EndgamePhase the mover had during the turn
+     * @return Probability that mover finishes first, or -1 if the table does not apply
+     */
+    float AfterTurn(const LudoState& s, int mover, int opponent, int phase) const;
+
+private:
+    void* map;              ///< Start of the mapping
+    size_t mapSize;         ///< Length of the mapping
+    const uint16_t* data;   ///< Value array inside the mapping
+    int numTokens;          ///< Tokens per player
+    int configCount;        ///< Configurations per player
+};
+
+/**
+ * @brief Returns the tablebase for a token count, mapping it on first use
+ *
+ * Looks for endgame-<tokens>.tb in the assets directory.
+ *
+ * @param tokens Tokens per player
+ * @return Mapped table, or nullptr if none is available
+ */
+const Tablebase* GetTablebase(int tokens);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "raylib.h"
+#include "TokenBatch.h"
+#include "Tween.h"
 #include <tuple>
 #include <semaphore.h>
 
@@ -22,7 +24,9 @@ public:
     bool finished;                      ///< Flag indicating if token has reached home
     bool isOut;                         ///< Flag indicating if token is out of starting area
     sem_t semToken;                     ///< Semaphore for thread-safe token operations
-    Texture2D token;                    ///< Token's visual texture
+    int sprite;                         ///< Frame of the token atlas the token is drawn with
+    Color tint;                         ///< Tint applied when drawing the texture
+    Tween* tween;                       ///< Move being animated, from tweenPool, or nullptr
 
     /**
      * @brief Default constructor
@@ -31,10 +35,11 @@ public:
     Token();
 
     /**
-     * @brief Sets the token's texture
-     * @param t Texture2D object to be used for the token
+     * @brief Sets the token's look and resets its state
+     * @param frame Frame of the token atlas
+     * @param c Tint to draw it with
      */
-    void setTexture(Texture2D t);
+    void setSprite(int frame, Color c = WHITE);
 
     /**
      * @brief Sets the token's starting position
@@ -49,9 +54,24 @@ public:
     void updateGrid();
 
     /**
-     * @brief Draws the token in its initial position
+     * @brief Queues the token for this frame's token batch
+     * A token still walking its last move is drawn along the path, and
+     * its tween goes back to the pool once it arrives
+     * @param batch Batch every token of the frame is drawn with
      */
-    void drawInit();
+    void draw(TokenBatch& batch);
+
+    /**
+     * @brief Animates a move the rules have already made
+     * @param from Relative position before the move
+     * @param to Relative position after the move
+     */
+    void animate(int from, int to);
+
+    /**
+     * @brief Stops any animation; the token is drawn where it is
+     */
+    void stopAnimation();
 
     /**
      * @brief Moves token out of starting area
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Rules.h"
+#include "raylib.h"
+
+/**
+ * @brief Draws every token of a frame as one batch of textured quads
+ *
+ * The token images are packed side by side into one sheet when the window
+ * opens. The atlas texture is rendered from it at the size tokens appear on
+ * screen, once per resolution or board change. Tokens are queued with their position, atlas frame and tint
+ * during the frame and submitted together through rlgl, so the whole board
+ * of tokens costs one draw call however many seats and tokens there are.
+ */
+class TokenBatch {
+public:
+    static const int CAPACITY = BOARD_MAX_ARMS * RULES_MAX_TOKENS;  ///< Every token of the largest match
+    static const int MAX_FRAMES = 8;                                 ///< Images the atlas can hold
+
+    TokenBatch();
+
+    /**
+     * @brief Packs token images into the atlas sheet
+     * Images of other sizes are scaled to the size of the first. Rescale
+     * must be called before anything is drawn
+     * @param paths Image files, one atlas frame each
+     * @param n Number of images
+     * @return true if every image was loaded
+     */
+    bool Load(const char* const* paths, int n);
+
+    /**
+     * @brief Renders the atlas texture for a token size
+     * Does nothing if the atlas already has that size
+     * @param pixelWidth Framebuffer pixels across one token
+     */
+    void Rescale(int pixelWidth);
+
+    /**
+     * @brief Releases the atlas sheet and texture
+     */
+    void Unload();
+
+    /**
+     * @brief Forgets the tokens queued for the last frame
+     */
+    void Clear() { count = 0; }
+
+    /**
+     * @brief Queues a token for this frame
+     * @param x Pixel column of its top-left corner
+     * @param y Pixel row of its top-left corner
+     * @param frame Atlas frame to draw
+     * @param tint Tint to draw it with
+     */
+    void Add(float x, float y, int frame, Color tint);
+
+    /**
+     * @brief Submits every queued token in one batch
+     * @param width Width to draw every token at; the height keeps the image's aspect
+     */
+    void Draw(float width) const;
+
+    int Count() const { return count; }
+
+private:
+    /** @brief One queued token */
+    struct Sprite {
+        float x, y;     ///< Top-left pixel
+        int frame;      ///< Atlas frame
+        Color tint;     ///< Tint
+    };
+
+    Image sheet;                ///< Every token image side by side, as loaded
+    Texture2D atlas;            ///< The sheet rendered at the on-screen token size
+    int frames;                 ///< Images in the atlas
+    int frameWidth;             ///< Width of one image in the sheet
+    int frameHeight;            ///< Height of the sheet
+    int atlasWidth;             ///< Pixel width of one frame of atlas
+    Sprite sprites[CAPACITY];   ///< Tokens queued this frame
+    int count;                  ///< Entries of sprites in use
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <stop_token>
+#include <vector>
+
+/**
+ * @brief Coroutine handle owner for a player's turn loop
+ *
+ * A TurnTask starts suspended and is only resumed by a TurnScheduler.
+ * Destroying the task destroys the coroutine frame.
+ */
+class TurnTask {
+public:
+    struct promise_type {
+        TurnTask get_return_object() {
+            return TurnTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        /** @brief Frames are recycled, so a new match does not touch the heap */
+        static void* operator new(std::size_t size);
+        static void operator delete(void* frame, std::size_t size);
+    };
+
+    TurnTask() : handle(nullptr) {}
+    explicit TurnTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+    TurnTask(TurnTask&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    TurnTask& operator=(TurnTask&& other) noexcept;
+    TurnTask(const TurnTask&) = delete;
+    TurnTask& operator=(const TurnTask&) = delete;
+    ~TurnTask();
+
+    /**
+     * @brief Checks if the coroutine has run to completion
+     * @return true if finished or empty
+     */
+    bool done() const { return !handle || handle.done(); }
+
+    std::coroutine_handle<promise_type> handle;  ///< Owned coroutine frame
+};
+
+/**
+ * @brief Single-threaded scheduler that drives player coroutines
+ *
+ * Each tick resumes every coroutine that is ready to run. Coroutines either
+ * yield until the next tick (polling for input) or park until their seat is
+ * woken, so idle seats cost nothing. One thread can drive any number of seats.
+ *
+ * Once the stop token fires, awaiting never suspends, so a coroutine that
+ * is resumed runs straight to its next stop check and returns.
+ */
+class TurnScheduler {
+public:
+    /**
+     * @brief Awaiter that suspends the coroutine until the next tick
+     */
+    struct NextTickAwaiter {
+        TurnScheduler* scheduler;
+        bool await_ready() const noexcept { return scheduler->StopRequested(); }
+        void await_suspend(std::coroutine_handle<> h) { scheduler->next.push_back(h); }
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Awaiter that parks the coroutine until its seat is woken
+     */
+    struct WaitTurnAwaiter {
+        TurnScheduler* scheduler;
+        int seat;
+        bool await_ready() const noexcept { return scheduler->StopRequested(); }
+        void await_suspend(std::coroutine_handle<> h) { scheduler->Park(seat, h); }
+        void await_resume() const noexcept {}
+    };
+
+    TurnScheduler();
+
+    /**
+     * @brief Takes ownership of a task and schedules its first resume
+     * @param task Coroutine to run
+     */
+    void Spawn(TurnTask task);
+
+    /**
+     * @brief Suspends the calling coroutine until the next tick
+     */
+    NextTickAwaiter NextTick() { return NextTickAwaiter{this}; }
+
+    /**
+     * @brief Parks the calling coroutine until Wake() is called for its seat
+     * @param seat Seat index the coroutine plays for
+     */
+    WaitTurnAwaiter WaitForTurn(int seat) { return WaitTurnAwaiter{this, seat}; }
+
+    /**
+     * @brief Makes a parked seat runnable on the next tick
+     * @param seat Seat index to wake
+     */
+    void Wake(int seat);
+
+    /**
+     * @brief Resumes all runnable coroutines once
+     * @return Number of coroutines resumed
+     */
+    int Tick();
+
+    /**
+     * @brief Makes every parked seat runnable on the next tick
+     */
+    void WakeAll();
+
+    /**
+     * @brief Sets the token that asks coroutines to finish
+     * @param token Stop token, usually from the owner's std::stop_source
+     */
+    void SetStopToken(std::stop_token token) { stopToken = token; }
+
+    /**
+     * @brief Checks if coroutines have been asked to finish
+     */
+    bool StopRequested() const { return stopToken.stop_requested(); }
+
+    /**
+     * @brief Destroys all tasks and forgets parked and queued handles
+     */
+    void Clear();
+
+    /**
+     * @brief Number of tasks that have not finished yet
+     */
+    int Active() const;
+
+private:
+    void Park(int seat, std::coroutine_handle<> h);
+
+    std::vector<TurnTask> tasks;                    ///< Owned coroutine frames
+    std::vector<std::coroutine_handle<>> ready;     ///< Handles resumed this tick
+    std::vector<std::coroutine_handle<>> next;      ///< Handles yielded for the next tick
+    std::vector<std::coroutine_handle<>> parked;    ///< Parked handle per seat (null if none)
+    std::stop_token stopToken;                      ///< Fires when coroutines should finish
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "BoardGeometry.h"
+#include "Rules.h"
+#include <cstdint>
+
+/** @brief Most cells one move walks: a single die */
+const int TWEEN_MAX_STEPS = 6;
+
+/** @brief Time a token takes to cross one cell, in nanoseconds */
+const uint64_t TWEEN_STEP_NS = 90000000ULL;
+
+/**
+ * @brief A token gliding cell by cell from where a move started to where it ended
+ *
+ * The rules move the token at once; a tween only changes where it is drawn.
+ * The path is looked up when the move is made, so sampling it every frame is
+ * a little arithmetic and no rules work.
+ */
+struct Tween {
+    BoardPoint path[TWEEN_MAX_STEPS + 1];  ///< Pixel of the start and of every cell walked
+    int steps;                             ///< Cells walked
+    uint64_t startNs;                      ///< MetricsNowNs() when the move was made
+    Tween* nextFree;                       ///< Next unused tween while in the pool's free list
+
+    /**
+     * @brief Builds the path of a move
+     * Follows the track the way MoveTarget does, turning into the home
+     * column at the tip when the move ends there
+     * @param g Board being played
+     * @param player 0-based owner of the token
+     * @param from Relative position before the move
+     * @param to Relative position after the move
+     * @param start Pixel the token is drawn at before the move
+     * @param now MetricsNowNs() of the move
+     */
+    void Start(const BoardGeometry& g, int player, int from, int to, BoardPoint start, uint64_t now);
+
+    /**
+     * @brief Where the token is drawn at a point in time
+     * @param now MetricsNowNs() of the frame
+     * @param x Receives the pixel column
+     * @param y Receives the pixel row
+     * @return false once the token has arrived; x and y are then the end of the path
+     */
+    bool Sample(uint64_t now, float& x, float& y) const;
+};
+
+/**
+ * @brief Fixed pool of tweens for every token a match can have
+ *
+ * Tweens are handed out from a free list and given back when the token
+ * arrives, so animating a move never allocates. A token holds at most one
+ * tween, so the pool cannot run dry; if it ever did, the token would jump.
+ * Used with the game mutex held.
+ */
+class TweenPool {
+public:
+    static const int CAPACITY = BOARD_MAX_ARMS * RULES_MAX_TOKENS;  ///< One tween per token of the largest match
+
+    TweenPool();
+
+    TweenPool(const TweenPool&) = delete;
+    TweenPool& operator=(const TweenPool&) = delete;
+
+    /**
+     * @brief Takes an unused tween
+     * @return Tween, or nullptr if all are in use
+     */
+    Tween* Acquire();
+
+    /**
+     * @brief Gives a tween back to the pool
+     */
+    void Release(Tween* t);
+
+    /**
+     * @brief Gives every tween back at once, as when a match ends
+     */
+    void Clear();
+
+    int InUse() const { return inUse; }
+
+private:
+    Tween tweens[CAPACITY];   ///< Backing storage
+    Tween* freeList;          ///< First unused tween
+    int inUse;                ///< Tweens handed out
+};
@@ -1,14 +1,49 @@
 #pragma once
 
+#include "MatchArena.h"
+#include "Replay.h"
+#include "Rules.h"
+#include "Tween.h"
 #include <tuple>
 #include <vector>
 
 /** @brief Total number of tokens in play */
 extern int numTokens;
 
+/** @brief Registry id of the BoardGeometry the current match is played on */
+extern int activeBoard;
+
 /** @brief 2D array storing 3D coordinates for each position on the Ludo board */
 extern std::tuple<int, int, int> **LudoGrid;
 
+/** @brief Backing memory for LudoGrid and all tokens of the current match */
+extern MatchArena matchArena;
+
+/** @brief Rules view of LudoGrid, with the occupancy of every track cell */
+extern LudoState matchState;
+
+/** @brief Every die used in the current match, for replays and analysis */
+extern MatchRecord matchRecord;
+
+/** @brief Tokens drawn on every board spot: bit k of spotTokens[s][p] is token k of player p */
+extern uint8_t spotTokens[BOARD_MAX_SPOTS][BOARD_MAX_ARMS];
+
+/** @brief Animations of the token moves of the current match */
+extern TweenPool tweenPool;
+
+/**
+ * @brief Mouse input as one logic tick sees it
+ * The render loop latches clicks and every click reaches exactly one tick,
+ * however the frame rate and tick rate compare
+ */
+struct TickInput {
+    bool clicked;   ///< Left button pressed since the previous tick
+    int x, y;       ///< Window position of the click
+};
+
+/** @brief Input of the logic tick running now; only the scheduler thread touches it */
+extern TickInput tickInput;
+
 /** @brief Vector storing dice roll values for the current turn */
 extern std::vector<int> diceVal;
 
@@ -43,6 +78,28 @@ extern std::vector<int> winners;
  */
 bool isTokenSafe(std::tuple<int, int, int> g);
 
+/**
+ * @brief Puts every token of a new match in its yard
+ * Fills LudoGrid, which must already be allocated, matchState and spotTokens,
+ * and starts recording the match in matchRecord
+ */
+void ResetGrid();
+
+/**
+ * @brief Writes a token's LudoGrid entry and keeps matchState and spotTokens in step
+ * Does nothing if the entry is unchanged, so it is cheap to call every frame
+ * @param player 0-based owner of the token
+ * @param token Index of the token
+ * @param g New grid position; negative for the yard
+ */
+void SetGrid(int player, int token, const std::tuple<int, int, int>& g);
+
+/**
+ * @brief Resets dice, turn order and winners for a new match
+ * Keeps numTokens and the capacity of every vector, so nothing is allocated
+ */
+void ResetMatchState();
+
 /**
  * @brief Generates the sequence of player turns
  * Determines turn order based on active players and game rules
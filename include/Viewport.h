@@ -0,0 +1,102 @@
+#pragma once
+
+#include "raylib.h"
+
+/**
+ * @brief Maps the game's fixed logical canvas onto the window
+ *
+ * Everything is laid out and hit-tested in logical coordinates (the
+ * 1200 x 900 canvas the game was designed for). The canvas is scaled
+ * uniformly to fit the window and centred, with bars on the sides that do
+ * not fit. The mapping is recomputed only when the window size or DPI
+ * changes; drawing goes through a Camera2D built from it.
+ */
+class Viewport {
+public:
+    /**
+     * @param width Logical canvas width
+     * @param height Logical canvas height
+     */
+    Viewport(int width, int height);
+
+    /**
+     * @brief Picks up a window resize or DPI change
+     * Cheap when nothing changed; call once per frame before drawing
+     * @return true if the mapping changed, so scaled assets must be rebuilt
+     */
+    bool Update();
+
+    /**
+     * @brief Camera that draws logical coordinates into the window
+     */
+    Camera2D Camera() const;
+
+    /**
+     * @brief Converts a window position, such as the mouse, to logical coordinates
+     */
+    Vector2 ToLogical(Vector2 window) const;
+
+    /**
+     * @brief Window units per logical unit
+     */
+    float Scale() const { return scale; }
+
+    /**
+     * @brief Framebuffer pixels per logical unit; scaled assets are rendered at this density
+     */
+    float PixelScale() const { return pixelScale; }
+
+private:
+    int width;              ///< Logical canvas width
+    int height;             ///< Logical canvas height
+    int windowWidth;        ///< Window width the mapping was computed for
+    int windowHeight;       ///< Window height the mapping was computed for
+    float dpi;              ///< Framebuffer pixels per window unit the mapping was computed for
+    float scale;            ///< Window units per logical unit
+    float pixelScale;       ///< Framebuffer pixels per logical unit
+    Vector2 offset;         ///< Window position of the canvas origin
+};
+
+/**
+ * @brief A texture kept at the pixel density of the current viewport
+ *
+ * The source image stays in memory; a texture rendered at the viewport's
+ * pixel density is made from it once per resolution change, so it is drawn
+ * 1:1 on screen without being rescaled every frame.
+ */
+class ScaledTexture {
+public:
+    ScaledTexture();
+
+    /**
+     * @brief Loads the source image
+     * @return true on success
+     */
+    bool Load(const char* path);
+
+    /**
+     * @brief Renders the texture for a new pixel density
+     * @param pixelScale Framebuffer pixels per logical unit
+     */
+    void Rescale(float pixelScale);
+
+    /**
+     * @brief Releases the source image and the texture
+     */
+    void Unload();
+
+    /**
+     * @brief Draws the texture at its logical size
+     * @param x Logical column of the top-left corner
+     * @param y Logical row of the top-left corner
+     * @param tint Tint to draw it with
+     */
+    void Draw(float x, float y, Color tint) const;
+
+    float width;            ///< Logical width, the source image's width
+    float height;           ///< Logical height, the source image's height
+
+private:
+    Image source;           ///< Image as loaded
+    Texture2D texture;      ///< Rendered for the current pixel density
+};
@@ -0,0 +1,340 @@
+/**
+ * @file BatchSim.cpp
+ * @brief Lockstep multi-game simulator with AVX2, SSE4.1 and scalar kernels
+ *
+ * The kernel is written once against a small lane-vector type. Masks are
+ * lanes of all ones (true) or zeros (false), as produced by the compare
+ * instructions, so selection is a blend and no lane ever branches.
+ */
+
+#include "../include/BatchSim.h"
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+namespace {
+
+#if defined(__AVX2__)
+
+struct Vec { __m256i v; };
+
+inline Vec Set(int x) { return { _mm256_set1_epi32(x) }; }
+inline Vec Load(const int32_t* p) { return { _mm256_load_si256((const __m256i*)p) }; }
+inline void Store(int32_t* p, Vec a) { _mm256_store_si256((__m256i*)p, a.v); }
+inline Vec operator+(Vec a, Vec b) { return { _mm256_add_epi32(a.v, b.v) }; }
+inline Vec operator-(Vec a, Vec b) { return { _mm256_sub_epi32(a.v, b.v) }; }
+inline Vec operator&(Vec a, Vec b) { return { _mm256_and_si256(a.v, b.v) }; }
+inline Vec operator|(Vec a, Vec b) { return { _mm256_or_si256(a.v, b.v) }; }
+inline Vec AndNot(Vec a, Vec b) { return { _mm256_andnot_si256(a.v, b.v) }; }
+inline Vec Eq(Vec a, Vec b) { return { _mm256_cmpeq_epi32(a.v, b.v) }; }
+inline Vec Gt(Vec a, Vec b) { return { _mm256_cmpgt_epi32(a.v, b.v) }; }
+inline Vec Select(Vec mask, Vec a, Vec b) { return { _mm256_blendv_epi8(b.v, a.v, mask.v) }; }
+
+const char* const KERNEL_NAME = "AVX2";
+
+#elif defined(__SSE4_1__)
+
+struct Vec { __m128i lo, hi; };
+
+inline Vec Set(int x) { return { _mm_set1_epi32(x), _mm_set1_epi32(x) }; }
+inline Vec Load(const int32_t* p) { return { _mm_load_si128((const __m128i*)p), _mm_load_si128((const __m128i*)(p + 4)) }; }
+inline void Store(int32_t* p, Vec a) { _mm_store_si128((__m128i*)p, a.lo); _mm_store_si128((__m128i*)(p + 4), a.hi); }
+inline Vec operator+(Vec a, Vec b) { return { _mm_add_epi32(a.lo, b.lo), _mm_add_epi32(a.hi, b.hi) }; }
+inline Vec operator-(Vec a, Vec b) { return { _mm_sub_epi32(a.lo, b.lo), _mm_sub_epi32(a.hi, b.hi) }; }
+inline Vec operator&(Vec a, Vec b) { return { _mm_and_si128(a.lo, b.lo), _mm_and_si128(a.hi, b.hi) }; }
+inline Vec operator|(Vec a, Vec b) { return { _mm_or_si128(a.lo, b.lo), _mm_or_si128(a.hi, b.hi) }; }
+inline Vec AndNot(Vec a, Vec b) { return { _mm_andnot_si128(a.lo, b.lo), _mm_andnot_si128(a.hi, b.hi) }; }
+inline Vec Eq(Vec a, Vec b) { return { _mm_cmpeq_epi32(a.lo, b.lo), _mm_cmpeq_epi32(a.hi, b.hi) }; }
+inline Vec Gt(Vec a, Vec b) { return { _mm_cmpgt_epi32(a.lo, b.lo), _mm_cmpgt_epi32(a.hi, b.hi) }; }
+inline Vec Select(Vec mask, Vec a, Vec b) {
+    return { _mm_blendv_epi8(b.lo, a.lo, mask.lo), _mm_blendv_epi8(b.hi, a.hi, mask.hi) };
+}
+
+const char* const KERNEL_NAME = "SSE4.1";
+
+#else
+
+struct Vec { int32_t v[BATCH_LANES]; };
+
+template <class Op>
+inline Vec Map(Vec a, Vec b, Op op) {
+    Vec r;
+    for (int i = 0; i < BATCH_LANES; i++) r.v[i] = op(a.v[i], b.v[i]);
+    return r;
+}
+
+inline Vec Set(int x) { Vec r; for (int i = 0; i < BATCH_LANES; i++) r.v[i] = x; return r; }
+inline Vec Load(const int32_t* p) { Vec r; memcpy(r.v, p, sizeof(r.v)); return r; }
+inline void Store(int32_t* p, Vec a) { memcpy(p, a.v, sizeof(a.v)); }
+inline Vec operator+(Vec a, Vec b) { return Map(a, b, [](int32_t x, int32_t y) { return x + y; }); }
+inline Vec operator-(Vec a, Vec b) { return Map(a, b, [](int32_t x, int32_t y) { return x - y; }); }
+inline Vec operator&(Vec a, Vec b) { return Map(a, b, [](int32_t x, int32_t y) { return x & y; }); }
+inline Vec operator|(Vec a, Vec b) { return Map(a, b, [](int32_t x, int32_t y) { return x | y; }); }
+inline Vec AndNot(Vec a, Vec b) { return Map(a, b, [](int32_t x, int32_t y) { return ~x & y; }); }
+inline Vec Eq(Vec a, Vec b) { return Map(a, b, [](int32_t x, int32_t y) { return x == y ? -1 : 0; }); }
+inline Vec Gt(Vec a, Vec b) { return Map(a, b, [](int32_t x, int32_t y) { return x > y ? -1 : 0; }); }
+inline Vec Select(Vec mask, Vec a, Vec b) {
+    Vec r;
+    for (int i = 0; i < BATCH_LANES; i++) r.v[i] = mask.v[i] ? a.v[i] : b.v[i];
+    return r;
+}
+
+const char* const KERNEL_NAME = "scalar";
+
+#endif
+
+const int NO_CELL_OPPONENT = -1;    // Off-track opponent tokens
+const int NO_CELL_TARGET = -2;      // Off-track targets; never equal to an opponent cell
+const int START_CELL = 8;           // Track cell of player 0's start square (see Rules.cpp)
+
+/**
+ * @brief Absolute track cell of relative positions, per lane
+ * @param base Player's start cell minus one, per lane
+ */
+inline Vec Cell(Vec base, Vec rel, int none) {
+    Vec onTrack = AndNot(Gt(rel, Set(TRACK_LENGTH)), Gt(rel, Set(0)));
+    Vec c = base + rel;
+    c = Select(Gt(c, Set(TRACK_LENGTH - 1)), c - Set(TRACK_LENGTH), c);
+    return Select(onTrack, c, Set(none));
+}
+
+/**
+ * @brief Safe squares by relative position: cell % 13 is 3 or 8 exactly
+ *        when the position % 13 is 9 or 1
+ */
+inline Vec IsSafe(Vec rel) {
+    const int safe[8] = { 1, 9, 14, 22, 27, 35, 40, 48 };
+    Vec m = Eq(rel, Set(safe[0]));
+    for (int i = 1; i < 8; i++) m = m | Eq(rel, Set(safe[i]));
+    return m;
+}
+
+} // namespace
+
+const char* BatchKernelName() {
+    return KERNEL_NAME;
+}
+
+BatchSimulator::BatchSimulator(int tokens, uint64_t seed, SimStats* stats)
+    : tokens(tokens), maxTurns(SimMaxTurns(BOARD_CLASSIC, tokens)), seed(seed), stats(stats), nextGame(0), lastGame(0) {
+    memset(pos, 0, sizeof(pos));
+    memset(home, 0, sizeof(home));
+    memset(player, 0, sizeof(player));
+    memset(die, 0, sizeof(die));
+}
+
+long long BatchSimulator::Run(long long first, long long last) {
+    nextGame = first;
+    lastGame = last;
+    int active = 0;
+    for (int l = 0; l < BATCH_LANES; l++) {
+        if (StartGame(l)) active++;
+    }
+    while (active > 0) {
+        for (int l = 0; l < BATCH_LANES; l++) PrepareLane(l);
+        Step();
+        active = 0;
+        for (int l = 0; l < BATCH_LANES; l++) {
+            FinishLane(l);
+            if (lanes[l].active) active++;
+        }
+    }
+    return last - first;
+}
+
+bool BatchSimulator::StartGame(int l) {
+    Lane& lane = lanes[l];
+    lane.active = nextGame < lastGame;
+    die[l] = 0;
+    if (!lane.active) return false;
+
+    lane.rng = SimRng(SimGameSeed(seed, (uint64_t)nextGame++));
+    lane.order = SimTurnOrder();
+    memset(lane.done, 0, sizeof(lane.done));
+    lane.placed = 0;
+    lane.turns = 0;
+    lane.numDice = 0;
+    lane.next = 0;
+    for (int p = 0; p < CLASSIC_PLAYERS; p++) {
+        home[p][l] = 0;
+        // Missing tokens count as finished so they never move or block
+        for (int t = 0; t < CLASSIC_TOKENS; t++) pos[p][t][l] = t < tokens ? POS_YARD : POS_FINISHED;
+    }
+    return true;
+}
+
+void BatchSimulator::EndGame(int l) {
+    Lane& lane = lanes[l];
+    bool finished = lane.placed == CLASSIC_PLAYERS - 1;
+    stats->turns.Add(lane.turns);
+    if (!finished) {
+        stats->unfinished.Add();
+        return;
+    }
+    for (int p = 0; p < CLASSIC_PLAYERS; p++) {
+        if (!lane.done[p]) lane.places[lane.placed] = p;
+    }
+    stats->games.Add();
+    stats->finishedTurns.Add(lane.turns);
+    stats->seatWins[lane.places[0]].Add();
+    for (int place = 0; place < CLASSIC_PLAYERS; place++) {
+        stats->seatPlaces[lane.places[place]][place].Add();
+    }
+    stats->gameLength.Add(lane.turns);
+    stats->gameLengthSketch.Add(lane.turns);
+}
+
+void BatchSimulator::PrepareLane(int l) {
+    Lane& lane = lanes[l];
+    while (lane.active) {
+        if (lane.next < lane.numDice) {
+            player[l] = lane.player;
+            die[l] = lane.dice[lane.next];
+            return;
+        }
+
+        // Turn over: end the game or start the next turn, as SimulateGame does
+        if (lane.placed == CLASSIC_PLAYERS - 1 || lane.turns >= maxTurns) {
+            EndGame(l);
+            StartGame(l);
+            continue;
+        }
+        lane.player = lane.order.Next(lane.rng, lane.done);
+        lane.turns++;
+        lane.numDice = 0;
+        lane.next = 0;
+        while (true) {
+            int d = lane.rng.Die();
+            if (d == 6 && lane.numDice == RULES_MAX_DICE - 1) {
+                lane.numDice = 0;
+                stats->tripleSixes.Add();
+                break;
+            }
+            lane.dice[lane.numDice++] = d;
+            if (d != 6) break;
+        }
+    }
+    die[l] = 0;
+}
+
+void BatchSimulator::FinishLane(int l) {
+    Lane& lane = lanes[l];
+    if (!lane.active || die[l] == 0) return;
+    lane.next++;
+    if (chosen[l] < 0) return;
+
+    stats->moves.Add();
+    if (captured[l] > 0) {
+        stats->captures.Add(captured[l]);
+        stats->capturesBySquare[TrackCell(lane.player, movedTo[l])].Add(captured[l]);
+    }
+    if (AllFinished(l, lane.player)) {
+        lane.done[lane.player] = true;
+        lane.places[lane.placed++] = lane.player;
+        lane.next = lane.numDice;
+    }
+}
+
+bool BatchSimulator::AllFinished(int l, int p) const {
+    for (int t = 0; t < tokens; t++) {
+        if (pos[p][t][l] != POS_FINISHED) return false;
+    }
+    return true;
+}
+
+void BatchSimulator::Step() {
+    Vec P = Load(player);
+    Vec D = Load(die);
+    Vec hasDie = Gt(D, Set(0));
+
+    // Per-player lane masks and the mover's home flag and start cell
+    Vec isP[CLASSIC_PLAYERS];
+    Vec base[CLASSIC_PLAYERS];
+    Vec canGoHome = Set(0);
+    Vec moverBase = Set(0);
+    for (int q = 0; q < CLASSIC_PLAYERS; q++) {
+        isP[q] = Eq(P, Set(q));
+        base[q] = Set(q * ARM_LENGTH + START_CELL - 1);
+        canGoHome = canGoHome | (isP[q] & Load(home[q]));
+        moverBase = Select(isP[q], base[q], moverBase);
+    }
+
+    // Track cells of every token; the mover's own tokens are masked out below
+    Vec cells[CLASSIC_PLAYERS][CLASSIC_TOKENS];
+    for (int q = 0; q < CLASSIC_PLAYERS; q++) {
+        for (int t = 0; t < CLASSIC_TOKENS; t++) {
+            cells[q][t] = Cell(base[q], Load(pos[q][t]), NO_CELL_OPPONENT);
+        }
+    }
+
+    Vec bestScore = Set(-1);
+    Vec bestToken = Set(-1);
+    Vec bestTo = Set(0);
+    Vec bestCell = Set(NO_CELL_TARGET);
+    Vec bestCapture = Set(0);
+
+    for (int t = 0; t < CLASSIC_TOKENS; t++) {
+        Vec from = Set(0);
+        for (int q = 0; q < CLASSIC_PLAYERS; q++) from = Select(isP[q], Load(pos[q][t]), from);
+
+        // MoveTarget: yard needs a six, the home column needs an exact roll
+        Vec target = from + D;
+        Vec isYard = Eq(from, Set(POS_YARD));
+        Vec isDone = Eq(from, Set(POS_FINISHED));
+        Vec inColumn = AndNot(isDone, Gt(from, Set(TRACK_LENGTH)));
+        Vec entersHome = AndNot(isYard, canGoHome & Gt(Set(POS_TIP + 1), from) & Gt(target, Set(POS_TIP)));
+
+        Vec to = Select(Gt(target, Set(TRACK_LENGTH)), target - Set(TRACK_LENGTH), target);
+        to = Select(entersHome, target + Set(1), to);
+        to = Select(inColumn, target, to);
+        to = Select(isYard, Set(POS_START), to);
+
+        Vec overshoot = (entersHome | inColumn) & Gt(to, Set(POS_FINISHED));
+        Vec legal = AndNot(isDone | overshoot, hasDie);
+        legal = AndNot(AndNot(Eq(D, Set(6)), isYard), legal);
+
+        // Capture: an opponent token on the (unsafe) target cell
+        Vec cell = Cell(moverBase, to, NO_CELL_TARGET);
+        Vec safe = IsSafe(to);
+        Vec hit = Set(0);
+        for (int q = 0; q < CLASSIC_PLAYERS; q++) {
+            for (int u = 0; u < CLASSIC_TOKENS; u++) hit = hit | AndNot(isP[q], Eq(cells[q][u], cell));
+        }
+        Vec capture = AndNot(safe, hit);
+
+        // GreedyScore, -1 for illegal moves; strict > keeps the first best token
+        Vec score = to + (capture & Set(1000)) + (Eq(to, Set(POS_FINISHED)) & Set(800)) +
+                    (isYard & Set(600)) + (safe & Set(200));
+        score = Select(legal, score, Set(-1));
+        Vec better = Gt(score, bestScore);
+        bestScore = Select(better, score, bestScore);
+        bestToken = Select(better, Set(t), bestToken);
+        bestTo = Select(better, to, bestTo);
+        bestCell = Select(better, cell, bestCell);
+        bestCapture = Select(better, capture, bestCapture);
+    }
+
+    // Apply the chosen move, send captured opponents home and unlock the home column
+    Vec moved = Gt(bestToken, Set(-1));
+    Vec count = Set(0);
+    for (int q = 0; q < CLASSIC_PLAYERS; q++) {
+        Vec own = moved & isP[q];
+        for (int t = 0; t < CLASSIC_TOKENS; t++) {
+            Vec p = Load(pos[q][t]);
+            p = Select(own & Eq(bestToken, Set(t)), bestTo, p);
+            Vec sent = AndNot(isP[q], bestCapture & Eq(cells[q][t], bestCell));
+            p = Select(sent, Set(POS_YARD), p);
+            count = count - sent;
+            Store(pos[q][t], p);
+        }
+        Store(home[q], Load(home[q]) | (own & bestCapture));
+    }
+
+    Store(chosen, bestToken);
+    Store(movedTo, bestTo);
+    Store(captured, count);
+}
@@ -0,0 +1,258 @@
+/**
+ * @file BoardGeometry.cpp
+ * @brief Board description parser, lookup table construction and registry
+ */
+
+#include "../include/BoardGeometry.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+/** @brief Built-in boards; the first reproduces the classic board image exactly */
+const char* const BUILTIN_BOARDS[] = {
+    "arms 4\nlane 6\nsafe 3 8\ncell 60\ninner 2\n"
+    "yard 0 90 90 200 90 90 200 200 200 145 30 260 145 145 260 30 145\n"
+    "yard 1 630 90 740 90 630 200 740 200 685 30 800 145 685 260 570 145\n"
+    "yard 2 630 630 740 740 630 740 740 630 685 570 800 685 685 800 570 685\n"
+    "yard 3 90 630 200 630 90 740 200 740 145 570 260 685 145 800 30 685\n",
+    "arms 6\nlane 6\nsafe 3 8\ncell 46\n",
+    "arms 8\nlane 6\nsafe 3 8\ncell 42\n",
+};
+const int BUILTIN_COUNT = sizeof(BUILTIN_BOARDS) / sizeof(BUILTIN_BOARDS[0]);
+
+const double PI = 3.14159265358979323846;
+
+/**
+ * @brief Top-left pixel of the cell centred at a point given in cells from the board centre
+ */
+BoardPoint CellAt(const BoardGeometry& g, double x, double y) {
+    double half = g.size / 2.0 - g.cellSize / 2.0;
+    BoardPoint p;
+    p.x = (int16_t)std::lround(half + x * g.cellSize);
+    p.y = (int16_t)std::lround(half + y * g.cellSize);
+    return p;
+}
+
+/**
+ * @brief Fills the relative position, safe square and pixel tables
+ */
+void BuildTables(BoardGeometry& g, const bool* explicitYard) {
+    g.armLength = 2 * g.lane + 1;
+    g.start = g.lane + 2;
+    g.trackLength = g.arms * g.armLength;
+    g.tip = g.trackLength - 1;
+    g.homeFirst = g.trackLength + 1;
+    g.finished = g.trackLength + g.lane;
+    g.size = (2 * (g.inner + g.lane - 1) + 1) * g.cellSize;
+
+    for (int p = 0; p < BOARD_MAX_ARMS; p++) {
+        for (int pos = 0; pos < BOARD_MAX_POS; pos++) {
+            if (p < g.arms && pos >= 1 && pos <= g.trackLength)
+                g.cell[p][pos] = (int8_t)((p * g.armLength + g.start + pos - 1) % g.trackLength);
+            else
+                g.cell[p][pos] = -1;
+        }
+    }
+
+    memset(g.safe, 0, sizeof(g.safe));
+    for (int c = 0; c < g.trackLength; c++) {
+        if (g.safeArmCells & (1u << (c % g.armLength))) g.safe[c >> 6] |= 1ULL << (c & 63);
+    }
+
+    // Arms run clockwise on screen, the first pointing left. Along an arm the
+    // track goes out on one side, across the tip and back on the other.
+    for (int a = 0; a < g.arms; a++) {
+        g.armAngle[a] = (float)(180.0 + a * 360.0 / g.arms);
+        double angle = g.armAngle[a] * PI / 180.0;
+        double dx = std::cos(angle), dy = std::sin(angle);
+        double qx = dy, qy = -dx;
+        int far = g.inner + g.lane - 1;
+
+        for (int k = 0; k < g.lane; k++) {
+            double d = g.inner + k;
+            g.track[a * g.armLength + k] = CellAt(g, dx * d + qx, dy * d + qy);
+            d = far - k;
+            g.track[a * g.armLength + g.lane + 1 + k] = CellAt(g, dx * d - qx, dy * d - qy);
+        }
+        g.track[a * g.armLength + g.lane] = CellAt(g, dx * far, dy * far);
+        for (int c = 1; c <= g.lane; c++) {
+            g.home[a][c] = CellAt(g, dx * (far - c), dy * (far - c));
+        }
+        g.home[a][0] = g.track[a * g.armLength + g.lane];
+
+        // Yard spots: two columns in the wedge after the arm, inner rows first
+        if (explicitYard[a]) continue;
+        static const int ROW_ORDER[BOARD_YARD_SLOTS / 2] = { 1, 2, 0, 3 };
+        double mid = angle + PI / g.arms;
+        double rx = std::cos(mid), ry = std::sin(mid);
+        double centre = g.inner + g.lane - 2.5;
+        for (int s = 0; s < BOARD_YARD_SLOTS; s++) {
+            double r = centre + (ROW_ORDER[s / 2] - 1.5) * 1.1;
+            double side = s % 2 ? 0.55 : -0.55;
+            BoardPoint p = CellAt(g, rx * r - ry * side, ry * r + rx * side);
+            int limit = g.size - g.cellSize;
+            p.x = (int16_t)(p.x < 0 ? 0 : p.x > limit ? limit : p.x);
+            p.y = (int16_t)(p.y < 0 ? 0 : p.y > limit ? limit : p.y);
+            g.yard[a][s] = p;
+        }
+    }
+}
+
+/**
+ * @brief Lists every spot in the buckets its square overlaps
+ *
+ * A bucket keeps the first BOARD_HIT_SLOTS spots; only spots drawn on top of
+ * each other, such as repeated yard spots, can run past that.
+ */
+void BuildHitIndex(BoardGeometry& g) {
+    memset(g.hit, -1, sizeof(g.hit));
+    auto add = [&g](int spot) {
+        BoardPoint p = g.SpotPixel(spot);
+        int x0 = p.x < 0 ? 0 : p.x / g.cellSize, x1 = (p.x + g.cellSize - 1) / g.cellSize;
+        int y0 = p.y < 0 ? 0 : p.y / g.cellSize, y1 = (p.y + g.cellSize - 1) / g.cellSize;
+        for (int by = y0; by <= y1 && by < BOARD_HIT_GRID; by++) {
+            for (int bx = x0; bx <= x1 && bx < BOARD_HIT_GRID; bx++) {
+                int16_t* slots = g.hit[by][bx];
+                for (int k = 0; k < BOARD_HIT_SLOTS; k++) {
+                    if (slots[k] < 0) {
+                        slots[k] = (int16_t)spot;
+                        break;
+                    }
+                }
+            }
+        }
+    };
+    for (int c = 0; c < g.trackLength; c++) add(c);
+    for (int a = 0; a < g.arms; a++) {
+        for (int col = 1; col < g.lane; col++) add(BOARD_SPOT_HOME + a * BOARD_MAX_LANE + col);
+        for (int s = 0; s < BOARD_YARD_SLOTS; s++) add(BOARD_SPOT_YARD + a * BOARD_YARD_SLOTS + s);
+    }
+}
+
+} // namespace
+
+BoardRegistry::BoardRegistry() : count(0) {
+    for (int i = 0; i < BUILTIN_COUNT; i++) {
+        if (ParseBoardGeometry(BUILTIN_BOARDS[i], boards[count])) count++;
+    }
+}
+
+bool ParseBoardGeometry(const char* text, BoardGeometry& g) {
+    memset(&g, 0, sizeof(g));
+    g.arms = 4;
+    g.lane = 6;
+    g.cellSize = 60;
+    BoardPoint yard[BOARD_MAX_ARMS][BOARD_YARD_SLOTS];
+    bool explicitYard[BOARD_MAX_ARMS] = {};
+
+    std::istringstream in(text);
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream words(line);
+        std::string key;
+        if (!(words >> key)) continue;
+
+        bool ok = true;
+        if (key == "arms") ok = (bool)(words >> g.arms);
+        else if (key == "lane") ok = (bool)(words >> g.lane);
+        else if (key == "cell") ok = (bool)(words >> g.cellSize);
+        else if (key == "inner") ok = (bool)(words >> g.inner);
+        else if (key == "safe") {
+            int index;
+            while (words >> index) {
+                if (index < 0 || index >= 32) ok = false;
+                else g.safeArmCells |= 1u << index;
+            }
+        } else if (key == "yard") {
+            int player, x, y, slot = 0;
+            ok = (bool)(words >> player) && player >= 0 && player < BOARD_MAX_ARMS;
+            while (ok && slot < BOARD_YARD_SLOTS && words >> x >> y) {
+                yard[player][slot].x = (int16_t)x;
+                yard[player][slot].y = (int16_t)y;
+                slot++;
+            }
+            if (ok) {
+                // Spots not listed repeat the listed ones
+                for (int s = slot; s < BOARD_YARD_SLOTS && slot > 0; s++) yard[player][s] = yard[player][s % slot];
+                explicitYard[player] = slot > 0;
+            }
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cout << "Board description line " << lineNo << ": cannot read '" << line << "'" << std::endl;
+            return false;
+        }
+    }
+
+    if (g.arms < 2 || g.arms > BOARD_MAX_ARMS || g.lane < 2 || g.lane > BOARD_MAX_LANE ||
+        g.arms * (2 * g.lane + 1) > BOARD_MAX_TRACK || g.cellSize < 8 || g.inner < 0 ||
+        2 * (g.inner + g.lane - 1) + 1 >= BOARD_HIT_GRID) {
+        std::cout << "Board description out of range: " << g.arms << " arms of lane " << g.lane << std::endl;
+        return false;
+    }
+    if (g.inner == 0) {
+        // Neighbouring arms are three cells wide; keep their inner ends from overlapping
+        g.inner = (int)std::ceil(1.5 / std::tan(PI / g.arms) + 0.5 - 1e-9);
+        if (g.inner < 1) g.inner = 1;
+    }
+
+    BuildTables(g, explicitYard);
+    for (int p = 0; p < g.arms; p++) {
+        if (explicitYard[p]) memcpy(g.yard[p], yard[p], sizeof(yard[p]));
+    }
+    BuildHitIndex(g);
+    return true;
+}
+
+bool LoadBoardGeometry(const char* path, BoardGeometry& g) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cout << "Cannot open board description " << path << std::endl;
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    return ParseBoardGeometry(text.str().c_str(), g);
+}
+
+int BoardGeometry::SpotsAt(int x, int y, int* out) const {
+    if (x < 0 || y < 0) return 0;
+    int bx = x / cellSize, by = y / cellSize;
+    if (bx >= BOARD_HIT_GRID || by >= BOARD_HIT_GRID) return 0;
+    int count = 0;
+    for (int k = 0; k < BOARD_HIT_SLOTS && hit[by][bx][k] >= 0; k++) {
+        BoardPoint p = SpotPixel(hit[by][bx][k]);
+        if (x >= p.x && x < p.x + cellSize && y >= p.y && y < p.y + cellSize) out[count++] = hit[by][bx][k];
+    }
+    return count;
+}
+
+int RegisterBoard(const BoardGeometry& g) {
+    BoardRegistry& r = Boards();
+    if (r.count == BOARD_MAX_BOARDS) return -1;
+    r.boards[r.count] = g;
+    return r.count++;
+}
+
+int BoardCount() {
+    return Boards().count;
+}
+
+int StandardBoard(int arms) {
+    const BoardRegistry& r = Boards();
+    for (int i = 0; i < BUILTIN_COUNT && i < r.count; i++) {
+        if (r.boards[i].arms == arms) return i;
+    }
+    return -1;
+}
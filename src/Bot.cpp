@@ -0,0 +1,87 @@
+/**
+ * @file Bot.cpp
+ * @brief Move selection for computer-controlled seats
+ */
+
+#include "../include/Bot.h"
+#include "../include/Tablebase.h"
+#include "../include/Evaluator.h"
+#include <type_traits>
+
+namespace {
+
+/**
+ * @brief Finds the only opponent still in the game
+ * @return Opponent seat, or -1 if more than one (or none) is left
+ */
+int LastOpponent(const LudoState& s, int player) {
+    int found = -1;
+    int finished = Board(s.board).finished;
+    for (int p = 0; p < s.numPlayers; p++) {
+        if (p == player) continue;
+        for (int t = 0; t < s.numTokens; t++) {
+            if (s.pos[p][t] != finished) {
+                if (found >= 0 && found != p) return -1;
+                found = p;
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+} // namespace
+
+int GreedyScore(const LudoMove& m) {
+    int score = m.to;
+    if (m.flags & MOVE_CAPTURE) score += 1000;
+    if (m.flags & MOVE_FINISH) score += 800;
+    if (m.flags & MOVE_ENTER) score += 600;
+    if (m.flags & MOVE_SAFE) score += 200;
+    return score;
+}
+
+bool BotChooseMove(const LudoState& s, int player, const int* dice, int numDice, int phase, LudoMove& out) {
+    LudoMove moves[RULES_MAX_TOKENS];
+    int count = GenerateMoves<GameRules>(s, player, dice, 1, moves, RULES_MAX_TOKENS);
+    if (count == 0) return false;
+
+    // Exact endgame play: maximize the tablebase value over the whole queue.
+    // The tables are solved for the classic rules on the classic board only
+    int opponent = LastOpponent(s, player);
+    bool classic = std::is_same<GameRules, ClassicRules>::value && s.board == BOARD_CLASSIC;
+    const Tablebase* table = classic && opponent >= 0 ? GetTablebase(s.numTokens) : nullptr;
+    if (table != nullptr) {
+        auto leaf = [&](const LudoState& after) {
+            return (double)table->AfterTurn(after, player, opponent, phase);
+        };
+        int best = -1;
+        double bestValue = -1.0;
+        for (int i = 0; i < count; i++) {
+            LudoState next = s;
+            ApplyMove<GameRules>(next, player, moves[i]);
+            double v = BestTurnValue<GameRules>(next, player, dice + 1, numDice - 1, leaf);
+            if (v > bestValue) {
+                bestValue = v;
+                best = i;
+            }
+        }
+        if (best >= 0 && bestValue >= 0.0) {
+            out = moves[best];
+            return true;
+        }
+    }
+
+    // The trained evaluator scores every candidate at once when it ships
+    const Evaluator* evaluator = GetEvaluator();
+    if (evaluator != nullptr) {
+        return EvaluatorChooseMove(*evaluator, s, player, dice, out);
+    }
+
+    int best = 0;
+    for (int i = 1; i < count; i++) {
+        if (GreedyScore(moves[i]) > GreedyScore(moves[best])) best = i;
+    }
+    out = moves[best];
+    return true;
+}
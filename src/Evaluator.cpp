@@ -0,0 +1,235 @@
+/**
+ * @file Evaluator.cpp
+ * @brief Position features, batched scoring and the weights file
+ */
+
+#include "../include/Evaluator.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+namespace {
+
+/** @brief Feature slots, in the order of the weights */
+enum Feature {
+    F_BIAS,
+    F_PROGRESS,             ///< Mean share of the track covered by the player's tokens
+    F_YARD,                 ///< Share of tokens in the yard
+    F_FINISHED,             ///< Share of tokens finished
+    F_HOME_COLUMN,          ///< Share of tokens in the home column
+    F_EXPOSED,              ///< Share of tokens an opponent is one die behind
+    F_SAFE,                 ///< Share of tokens on safe squares
+    F_CAN_GO_HOME,          ///< The player may enter its home column
+    F_LAGGARD,              ///< Share of the track covered by the least advanced token
+    F_ON_TRACK,             ///< Share of tokens on the shared track
+    F_LEADER_PROGRESS,      ///< Progress of the most advanced opponent
+    F_OPP_PROGRESS,         ///< Mean progress of the opponents
+    F_OPP_YARD,             ///< Mean yard share of the opponents
+    F_LEADER_FINISHED,      ///< Finished share of the opponent closest to winning
+    F_THREATS,              ///< Share of opponent tokens the player is one die behind
+    F_OPP_CAN_GO_HOME       ///< Share of opponents that may enter their home column
+};
+
+static_assert(F_OPP_CAN_GO_HOME + 1 == EVAL_FEATURES, "every feature has a slot");
+
+/** @brief Per-player measures the features are built from */
+struct Side {
+    float progress, yard, finished, homeColumn, exposed, safe, laggard, onTrack;
+};
+
+/**
+ * @brief Measures one player's tokens
+ * @param hunters Bit per seat whose tokens count as a threat to this player's
+ */
+Side Measure(const LudoState& s, const BoardGeometry& g, int player, int hunters) {
+    Side side = {};
+    float n = (float)s.numTokens;
+    int laggard = g.finished;
+    for (int t = 0; t < s.numTokens; t++) {
+        int pos = s.pos[player][t];
+        side.progress += pos;
+        if (pos < laggard) laggard = pos;
+        if (pos == POS_YARD) side.yard++;
+        else if (pos == g.finished) side.finished++;
+        else if (pos >= g.homeFirst) side.homeColumn++;
+        else {
+            side.onTrack++;
+            int cell = g.cell[player][pos];
+            if (g.IsSafe(cell)) {
+                side.safe++;
+                continue;
+            }
+            // One die away: an opponent token on any of the six cells behind
+            for (int d = 1; d <= 6; d++) {
+                if (s.cells[(cell - d + g.trackLength) % g.trackLength] & hunters) {
+                    side.exposed++;
+                    break;
+                }
+            }
+        }
+    }
+    side.progress /= n * g.finished;
+    side.laggard = (float)laggard / g.finished;
+    side.yard /= n;
+    side.finished /= n;
+    side.homeColumn /= n;
+    side.exposed /= n;
+    side.safe /= n;
+    side.onTrack /= n;
+    return side;
+}
+
+inline float Logistic(float z) {
+    return 1.0f / (1.0f + std::exp(-z));
+}
+
+} // namespace
+
+void EvalFeatures(const LudoState& s, int player, float* out) {
+    const BoardGeometry& g = Board(s.board);
+    Side own = Measure(s, g, player, ~(1 << player));
+    out[F_BIAS] = 1.0f;
+    out[F_PROGRESS] = own.progress;
+    out[F_YARD] = own.yard;
+    out[F_FINISHED] = own.finished;
+    out[F_HOME_COLUMN] = own.homeColumn;
+    out[F_EXPOSED] = own.exposed;
+    out[F_SAFE] = own.safe;
+    out[F_CAN_GO_HOME] = (s.homeMask >> player) & 1;
+    out[F_LAGGARD] = own.laggard;
+    out[F_ON_TRACK] = own.onTrack;
+
+    float leader = 0.0f, progress = 0.0f, yard = 0.0f, finished = 0.0f, threats = 0.0f, home = 0.0f;
+    int opponents = 0;
+    for (int p = 0; p < s.numPlayers; p++) {
+        if (p == player) continue;
+        Side opp = Measure(s, g, p, 1 << player);
+        opponents++;
+        if (opp.progress > leader) leader = opp.progress;
+        if (opp.finished > finished) finished = opp.finished;
+        progress += opp.progress;
+        yard += opp.yard;
+        threats += opp.exposed;
+        home += (s.homeMask >> p) & 1;
+    }
+    float n = opponents > 0 ? (float)opponents : 1.0f;
+    out[F_LEADER_PROGRESS] = leader;
+    out[F_OPP_PROGRESS] = progress / n;
+    out[F_OPP_YARD] = yard / n;
+    out[F_LEADER_FINISHED] = finished;
+    out[F_THREATS] = threats / n;
+    out[F_OPP_CAN_GO_HOME] = home / n;
+}
+
+Evaluator::Evaluator() : weights{} {}
+
+bool Evaluator::Load(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return false;
+    EvaluatorHeader h;
+    float w[EVAL_FEATURES];
+    bool ok = fread(&h, sizeof(h), 1, f) == 1 &&
+              h.magic == EVALUATOR_MAGIC &&
+              h.version == EVALUATOR_VERSION &&
+              h.features == EVAL_FEATURES &&
+              fread(w, sizeof(float), EVAL_FEATURES, f) == (size_t)EVAL_FEATURES;
+    fclose(f);
+    if (ok) memcpy(weights, w, sizeof(weights));
+    return ok;
+}
+
+bool Evaluator::Save(const char* path, uint64_t games) const {
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) return false;
+    EvaluatorHeader h = {};
+    h.magic = EVALUATOR_MAGIC;
+    h.version = EVALUATOR_VERSION;
+    h.features = EVAL_FEATURES;
+    h.games = games;
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+              fwrite(weights, sizeof(float), EVAL_FEATURES, f) == (size_t)EVAL_FEATURES;
+    return fclose(f) == 0 && ok;
+}
+
+float Evaluator::Value(const float* features) const {
+    float z = 0.0f;
+    for (int f = 0; f < EVAL_FEATURES; f++) z += weights[f] * features[f];
+    return Logistic(z);
+}
+
+void Evaluator::ScoreBatch(const EvalBatch& batch, float* out) const {
+    alignas(32) float z[EVAL_LANES];
+#if defined(__AVX2__)
+    __m256 sum = _mm256_setzero_ps();
+    for (int f = 0; f < EVAL_FEATURES; f++) {
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[f]), _mm256_load_ps(batch.x[f])));
+    }
+    _mm256_store_ps(z, sum);
+#elif defined(__SSE4_1__)
+    __m128 lo = _mm_setzero_ps(), hi = _mm_setzero_ps();
+    for (int f = 0; f < EVAL_FEATURES; f++) {
+        __m128 w = _mm_set1_ps(weights[f]);
+        lo = _mm_add_ps(lo, _mm_mul_ps(w, _mm_load_ps(batch.x[f])));
+        hi = _mm_add_ps(hi, _mm_mul_ps(w, _mm_load_ps(batch.x[f] + 4)));
+    }
+    _mm_store_ps(z, lo);
+    _mm_store_ps(z + 4, hi);
+#else
+    for (int i = 0; i < EVAL_LANES; i++) z[i] = 0.0f;
+    for (int f = 0; f < EVAL_FEATURES; f++) {
+        for (int i = 0; i < EVAL_LANES; i++) z[i] += weights[f] * batch.x[f][i];
+    }
+#endif
+    for (int i = 0; i < batch.count; i++) out[i] = Logistic(z[i]);
+}
+
+const char* EvalKernelName() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE4_1__)
+    return "SSE4.1";
+#else
+    return "scalar";
+#endif
+}
+
+bool EvaluatorChooseMove(const Evaluator& e, const LudoState& s, int player, const int* dice, LudoMove& out) {
+    LudoMove moves[RULES_MAX_TOKENS];
+    int count = GenerateMoves<GameRules>(s, player, dice, 1, moves, RULES_MAX_TOKENS);
+    if (count == 0) return false;
+
+    // One lane per candidate; unused lanes are scored too but never read
+    EvalBatch batch = {};
+    batch.count = count;
+    for (int i = 0; i < count; i++) {
+        LudoState next = s;
+        ApplyMove<GameRules>(next, player, moves[i]);
+        float features[EVAL_FEATURES];
+        EvalFeatures(next, player, features);
+        for (int f = 0; f < EVAL_FEATURES; f++) batch.x[f][i] = features[f];
+    }
+    float values[EVAL_LANES];
+    e.ScoreBatch(batch, values);
+
+    int best = 0;
+    for (int i = 1; i < count; i++) {
+        if (values[i] > values[best]) best = i;
+    }
+    out = moves[best];
+    return true;
+}
+
+const Evaluator* GetEvaluator() {
+    static Evaluator evaluator;
+    static bool loaded = false;
+    static std::once_flag once;
+    std::call_once(once, []() { loaded = evaluator.Load("assets/evaluator.bin"); });
+    return loaded ? &evaluator : nullptr;
+}
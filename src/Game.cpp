@@ -5,6 +5,9 @@
 
 #include "../include/Game.h"
 #include "../include/Utils.h"
+#include "../include/Snapshot.h"
+#include "../include/Metrics.h"
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <cmath>
@@ -14,6 +17,23 @@ extern pthread_mutex_t mutex;        // General game state mutex
 extern pthread_mutex_t mutexDice;    // Dice rolling mutex  
 extern pthread_mutex_t mutexTurn;    // Turn management mutex
 
+/** @brief Logical font size of every cached glyph atlas; text uses the smallest tier at least its size */
+static const int FONT_TIER_SIZES[Game::FONT_TIERS] = { 25, 60, 120 };
+
+/** @brief Token images, one atlas frame per seat; later seats reuse the first, tinted */
+static const char* const TOKEN_IMAGES[] = {
+    "assets/red-goti.png", "assets/green-goti.png", "assets/yellow-goti.png", "assets/blue-goti.png"
+};
+static const int TOKEN_TEXTURES = sizeof(TOKEN_IMAGES) / sizeof(TOKEN_IMAGES[0]);
+
+/** @brief Name and color of every seat, in arm order */
+static const char* const SEAT_NAMES[BOARD_MAX_ARMS] = {
+    "RED", "GREEN", "YELLOW", "BLUE", "PURPLE", "ORANGE", "SKYBLUE", "BROWN"
+};
+static const Color SEAT_COLORS[BOARD_MAX_ARMS] = {
+    RED, GREEN, YELLOW, BLUE, PURPLE, ORANGE, SKYBLUE, BROWN
+};
+
 /**
  * @brief Draws text centered horizontally on the screen
  * @param text The text to draw
@@ -57,96 +77,200 @@ void DrawGradientText(const char* text, int x, int y, int fontSize, Color color1
 }
 
 /**
- * @brief Thread function for handling player actions
- * @param args Pointer to Player object
- * @return NULL
+ * @brief Work of one logic tick: wakes the seat to move and resumes the coroutines
+ * Runs on the scheduler thread with the game mutex held
+ * @param args Pointer to Game object
+ * @param input Click latched since the previous tick
  */
-void* playerThread(void* args) {
-    Player* p = (Player*)args;
-    while (!WindowShouldClose()) {
-        pthread_mutex_lock(&mutex);
-        p->rollDice();
-        p->move();
-        pthread_mutex_unlock(&mutex);
-    }
-    return NULL;
+static void GameLogicTick(void* args, const TickInput& input) {
+    Game* game = (Game*)args;
+    tickInput = input;
+    game->scheduler.Wake(turn - 1);
+    game->scheduler.Tick();
 }
 
 /**
  * @brief Constructor for Game class
  * Initializes game state variables
  */
-Game::Game() : screen(1), Initial(true), FinishedThreads(4, false), WinnerScreen(false) {}
+Game::Game() : screen(1), schedulerThread(scheduler, &mutex, &GameLogicTick, this), Initial(true),
+               FinishedThreads(BOARD_MAX_ARMS, false), WinnerScreen(false), botSeats(false), selectedBoard(BOARD_CLASSIC), viewport(SCREEN_WIDTH, SCREEN_HEIGHT),
+               liveInput(viewport), input(&liveInput), frame(0), replayEvent(0), showHints(false),
+               gameFonts{}, customFont(false), savePath("multiludo.sav"), replayPath("multiludo.mlr"), matchRequested(-1.0), metricsPath("multiludo.prom") {
+}
 
 /**
  * @brief Destructor for Game class
  * Cleans up resources and closes the window
  */
 Game::~Game() {
-    UnloadTexture(LudoBoard);
+    // A scheduler thread that missed the shutdown deadline is still joinable;
+    // wait for it before the coroutines and players it resumes go away
+    if (schedulerThread.Running()) {
+        schedulerThread.Join();
+        EndMatch();
+    }
+    LudoBoard.Unload();
     for (int i = 0; i < 6; i++) {
-        UnloadTexture(Dice[i]);
+        Dice[i].Unload();
+    }
+    tokenBatch.Unload();
+    if (customFont) {
+        for (int i = 0; i < FONT_TIERS; i++) {
+            UnloadFont(gameFonts[i]);
+        }
     }
-    UnloadFont(gameFont);
     CloseWindow();
 }
 
 /**
  * @brief Loads the custom game font
- * Falls back to default font if custom font fails to load
+ * Glyphs are rendered at the size they appear on screen, capped at
+ * MAX_GLYPH_PIXELS. Falls back to default font if custom font fails to load
  */
 void Game::LoadGameFont() {
-    gameFont = LoadFont("assets/Roboto-Bold.ttf");
-    if (gameFont.texture.id == 0) {
+    if (customFont) {
+        for (int i = 0; i < FONT_TIERS; i++) {
+            UnloadFont(gameFonts[i]);
+        }
+    }
+    customFont = true;
+    for (int i = 0; i < FONT_TIERS && customFont; i++) {
+        int pixels = (int)(FONT_TIER_SIZES[i] * viewport.PixelScale() + 0.5f);
+        gameFonts[i] = LoadFontEx("assets/Roboto-Bold.ttf", std::min(pixels, (int)MAX_GLYPH_PIXELS), NULL, 0);
+        if (gameFonts[i].texture.id == 0) {
+            for (int k = 0; k < i; k++) {
+                UnloadFont(gameFonts[k]);
+            }
+            customFont = false;
+        } else {
+            SetTextureFilter(gameFonts[i].texture, TEXTURE_FILTER_BILINEAR);
+        }
+    }
+    if (!customFont) {
         std::cout << "Failed to load font! Using default font instead." << std::endl;
-        gameFont = GetFontDefault();
+        std::fill(gameFonts, gameFonts + FONT_TIERS, GetFontDefault());
+    }
+}
+
+/**
+ * @brief Rebuilds every resolution-dependent asset from its source
+ */
+void Game::RescaleAssets() {
+    float pixelScale = viewport.PixelScale();
+    LudoBoard.Rescale(pixelScale);
+    for (int i = 0; i < 6; i++) {
+        Dice[i].Rescale(pixelScale);
+    }
+    tokenBatch.Rescale((int)(Board(activeBoard).cellSize * pixelScale + 0.5f));
+    LoadGameFont();
+}
+
+const Font& Game::FontFor(int fontSize) const {
+    for (int i = 0; i < FONT_TIERS - 1; i++) {
+        if (fontSize <= FONT_TIER_SIZES[i]) return gameFonts[i];
     }
+    return gameFonts[FONT_TIERS - 1];
+}
+
+Vector2 Game::MousePosition() const {
+    return input->MousePosition();
 }
 
 /**
  * @brief Initializes the game window and core components
  */
 void Game::Initialize() {
+    // Draw at the display's refresh rate; the rules tick on their own clock.
+    // The window can be resized freely and the canvas scales to fit it
+    SetConfigFlags(FLAG_VSYNC_HINT | FLAG_WINDOW_RESIZABLE | FLAG_WINDOW_HIGHDPI);
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "MultiLudo - A Multithreaded Board Game");
-    SetTargetFPS(60);
-    LoadGameFont();
+    int refresh = GetMonitorRefreshRate(GetCurrentMonitor());
+    SetTargetFPS(refresh > 0 ? refresh : 60);
     LoadTextures();
+    viewport.Update();
+    RescaleAssets();
+    StartScheduler();
+
+    // Size the match arena once for the largest match so later matches never allocate
+    matchArena.Reserve(MatchArena::MatchBytes(BOARD_MAX_ARMS, RULES_MAX_TOKENS));
+
+    // Resume a saved match before the first frame is drawn
+    if (!resumePath.empty()) {
+        if (!LoadSnapshot(*this, resumePath.c_str())) {
+            std::cout << "Failed to load snapshot: " << resumePath << std::endl;
+        }
+    }
+    if (!watchPath.empty() && !OpenReplay(watchPath.c_str())) {
+        std::cout << "Failed to open replay: " << watchPath << std::endl;
+    }
 }
 
 /**
- * @brief Loads all game textures from assets
+ * @brief Loads all game images from assets
  */
 void Game::LoadTextures() {
-    LudoBoard = LoadTexture("assets/board1.png");
+    LudoBoard.Load("assets/board1.png");
     for (int i = 0; i < 6; i++) {
         std::string path = "assets/" + std::to_string(i + 1) + "-dice.png";
-        Dice[i] = LoadTexture(path.c_str());
+        Dice[i].Load(path.c_str());
+    }
+
+    // Token images, in seat order, packed into one atlas so all tokens draw in one batch
+    if (!tokenBatch.Load(TOKEN_IMAGES, TOKEN_TEXTURES)) {
+        std::cout << "Some token images are missing" << std::endl;
     }
 }
 
 /**
- * @brief Initializes players and creates player threads
- * Sets up player tokens, colors and starts the game threads
+ * @brief Starts the scheduler thread
+ */
+void Game::StartScheduler() {
+    if (!schedulerThread.Start()) {
+        std::cout << "Failed to start the scheduler thread" << std::endl;
+    }
+}
+
+/**
+ * @brief Stops the scheduler thread and destroys the player coroutines
+ * Never waits longer than SchedulerThread::SHUTDOWN_DEADLINE_MS
+ */
+bool Game::StopScheduler() {
+    if (!schedulerThread.Running())
+        return true;
+    double ms = 0.0;
+    if (!schedulerThread.Stop(&ms)) {
+        // Leave the coroutines alone; the thread may still be resuming them
+        std::cout << "Scheduler thread missed the " << SchedulerThread::SHUTDOWN_DEADLINE_MS
+                  << " ms shutdown deadline" << std::endl;
+        return false;
+    }
+    std::cout << "Scheduler stopped in " << ms << " ms" << std::endl;
+    scheduler.Clear();
+    return true;
+}
+
+/**
+ * @brief Latches a click on the logical canvas for the scheduler thread
+ */
+void Game::LatchInput() {
+    Vector2 mouse = MousePosition();
+    schedulerThread.Latch((int)mouse.x, (int)mouse.y);
+}
+
+/**
+ * @brief Initializes players and spawns their turn coroutines
+ * Sets up player tokens, colors and hands each player to the scheduler
  */
 void Game::InitializePlayers() {
     if (Initial && numTokens > 0) {
-        // Load player token textures
-        Texture2D red = LoadTexture("assets/red-goti.png");
-        Texture2D green = LoadTexture("assets/green-goti.png");
-        Texture2D blue = LoadTexture("assets/blue-goti.png");
-        Texture2D yellow = LoadTexture("assets/yellow-goti.png");
-
-        // Initialize players with their colors and tokens
-        P1.setPlayer(0, RED, red);
-        P2.setPlayer(1, GREEN, green);
-        P3.setPlayer(2, YELLOW, yellow);
-        P4.setPlayer(3, BLUE, blue);
-
-        // Create threads for each player
-        pthread_create(&th[0], NULL, &playerThread, &P1);
-        pthread_create(&th[1], NULL, &playerThread, &P2);
-        pthread_create(&th[2], NULL, &playerThread, &P3);
-        pthread_create(&th[3], NULL, &playerThread, &P4);
+        SeatPlayers();
+
+        // One coroutine per player, all driven by the scheduler thread
+        int seats = Board(activeBoard).arms;
+        for (int i = 0; i < seats; i++) {
+            scheduler.Spawn(players[i].Play(scheduler));
+        }
 
         // Set up initial turn order
         GenerateTurns();
@@ -157,13 +281,241 @@ void Game::InitializePlayers() {
     }
 }
 
+/**
+ * @brief Gives every seat of the board its color and tokens
+ * Seats past the four images reuse the first tinted with their color
+ */
+void Game::SeatPlayers() {
+    int seats = Board(activeBoard).arms;
+    for (int i = 0; i < seats; i++) {
+        bool ownTexture = i < TOKEN_TEXTURES;
+        players[i].setPlayer(i, SEAT_COLORS[i], ownTexture ? i : 0,
+                             ownTexture ? WHITE : SEAT_COLORS[i]);
+        players[i].isBot = i > 0 && botSeats;
+    }
+}
+
+/**
+ * @brief Starts a new match with the selected number of tokens
+ * Carves the shared grid out of the match arena and initializes players
+ */
+void Game::StartMatch() {
+    EndMatch();
+    ResetMatchState();
+    std::fill(FinishedThreads.begin(), FinishedThreads.end(), false);
+    WinnerScreen = false;
+    activeBoard = selectedBoard;
+    int seats = Board(activeBoard).arms;
+    if (!matchArena.Reserve(MatchArena::MatchBytes(seats, numTokens))) {
+        std::cout << "Failed to reserve match memory" << std::endl;
+        return;
+    }
+    screen = 2;
+    LudoGrid = matchArena.AllocArray<std::tuple<int, int, int>*>(seats);
+    for (int i = 0; i < seats; i++) {
+        LudoGrid[i] = matchArena.AllocArray<std::tuple<int, int, int>>(numTokens);
+    }
+    ResetGrid();
+    InitializePlayers();
+
+    // Boards differ in cell size, and so in the pixel size of the token atlas
+    tokenBatch.Rescale((int)(Board(activeBoard).cellSize * viewport.PixelScale() + 0.5f));
+}
+
+/**
+ * @brief Ends the current match
+ * Coroutine frames go back to the frame pool and the arena is rewound
+ */
+void Game::EndMatch() {
+    scheduler.Clear();
+    for (Player& p : players) {
+        p.tokens = nullptr;
+    }
+    LudoGrid = nullptr;
+    tweenPool.Clear();
+    matchArena.Reset();
+    Initial = true;
+}
+
+/**
+ * @brief Starts the next match in place
+ * Only the rules state is reset; the next presented frame reports the latency
+ */
+void Game::Rematch() {
+    matchRequested = GetTime();
+    LockMutex(&mutex, LOCK_GAME);
+    StartMatch();
+    UnlockMutex(&mutex, LOCK_GAME);
+}
+
+/**
+ * @brief Writes the dice and moves of the match to replayPath
+ * Called with the scheduler thread kept out, so the record is not growing
+ */
+void Game::SaveReplay() {
+    if (!replayPath.empty() && !matchRecord.Save(replayPath.c_str())) {
+        std::cout << "Failed to save replay: " << replayPath << std::endl;
+    }
+}
+
+/**
+ * @brief Opens a recorded match on the replay screen
+ * The board is set up like a match, but no turn coroutines are spawned;
+ * the tokens only move when the replay seeks
+ */
+bool Game::OpenReplay(const char* path) {
+    MatchRecord loaded;
+    if (!loaded.Load(path)) return false;
+
+    LockMutex(&mutex, LOCK_GAME);
+    EndMatch();
+    ResetMatchState();
+    replay = std::move(loaded);
+    numTokens = replay.start.numTokens;
+    activeBoard = replay.start.board;
+    int seats = Board(activeBoard).arms;
+    bool ok = matchArena.Reserve(MatchArena::MatchBytes(seats, numTokens));
+    if (ok) {
+        LudoGrid = matchArena.AllocArray<std::tuple<int, int, int>*>(seats);
+        for (int i = 0; i < seats; i++) {
+            LudoGrid[i] = matchArena.AllocArray<std::tuple<int, int, int>>(numTokens);
+        }
+        ResetGrid();
+        SeatPlayers();
+        replayEvent = 0;
+        SeekReplay(0);
+        screen = 4;
+    }
+    UnlockMutex(&mutex, LOCK_GAME);
+
+    tokenBatch.Rescale((int)(Board(activeBoard).cellSize * viewport.PixelScale() + 0.5f));
+    return ok;
+}
+
+/**
+ * @brief Shows the position after a number of events of the replay
+ * Starts from the nearest keyframe, so any jump costs the same. A step of
+ * one event forward is animated like the move it replays
+ */
+void Game::SeekReplay(int event) {
+    int events = (int)replay.events.size();
+    event = std::clamp(event, 0, events);
+    LudoState s;
+    if (!replay.Seek(event, s)) return;
+    bool step = event == replayEvent + 1;
+    replayEvent = event;
+
+    const BoardGeometry& g = Board(activeBoard);
+    for (int p = 0; p < s.numPlayers; p++) {
+        players[p].score = 0;
+        for (int k = 0; k < numTokens; k++) {
+            Token& t = players[p].tokens[k];
+            int from = matchState.pos[p][k];
+            int to = s.pos[p][k];
+            t.stopAnimation();
+            t.canGoHome = !GameRules::CAPTURE_TO_ENTER_HOME || ((s.homeMask >> p) & 1);
+            t.finished = to == g.finished;
+            t.isOut = to != POS_YARD && !t.finished;
+            if (to == POS_YARD) {
+                t.setStart(p);
+                t.gridPos = std::make_tuple(-1, -1, -1);
+            } else {
+                BoardPoint px = g.Pixel(p, to);
+                t.x = px.x;
+                t.y = px.y;
+                t.gridPos = PosToGrid(p, to, activeBoard);
+            }
+            t.updateGrid();
+            if (step && to != from && to != POS_YARD) t.animate(from, to);
+            // The scoreboard counts finished tokens while watching
+            if (t.finished) players[p].score++;
+        }
+    }
+
+    // Seat and dice of the die played last, or the seat about to play
+    diceVal.assign(3, 0);
+    if (event == 0) {
+        turn = events > 0 ? replay.events[0].player + 1 : 1;
+        dice = 1;
+        return;
+    }
+    const ReplayEvent& last = replay.events[event - 1];
+    turn = last.player + 1;
+    dice = last.die;
+    int first = replay.TurnStart(replay.TurnOf(event - 1));
+    for (int i = first; i < event && i - first < 3; i++) {
+        diceVal[i - first] = replay.events[i].die;
+    }
+}
+
+/**
+ * @brief Moves through the replay with the scrubber and the arrow keys
+ * LEFT/RIGHT step one die, UP/DOWN one turn, HOME/END to either end and
+ * SPACE returns to the start screen
+ */
+void Game::UpdateReplay() {
+    int events = (int)replay.events.size();
+    Vector2 mouse = MousePosition();
+    Rectangle grab = {REPLAY_BAR.x - 8, REPLAY_BAR.y - 8, REPLAY_BAR.width + 16, REPLAY_BAR.height + 16};
+    if (input->MouseDown() && CheckCollisionPointRec(mouse, grab)) {
+        float share = std::clamp((mouse.x - REPLAY_BAR.x) / REPLAY_BAR.width, 0.0f, 1.0f);
+        int event = (int)(share * events + 0.5f);
+        if (event != replayEvent) SeekReplay(event);
+    }
+
+    // Turn boundaries come from the keyframe index, so stepping by turns is as cheap as by dice
+    int current = replayEvent < events ? replay.TurnOf(replayEvent) : replay.TurnCount() + 1;
+    if (input->KeyPressed(KEY_RIGHT)) SeekReplay(replayEvent + 1);
+    else if (input->KeyPressed(KEY_LEFT)) SeekReplay(replayEvent - 1);
+    else if (input->KeyPressed(KEY_UP)) SeekReplay(replay.TurnStart(current + 1));
+    else if (input->KeyPressed(KEY_DOWN)) {
+        int start = replay.TurnStart(current);
+        SeekReplay(replayEvent > start ? start : replay.TurnStart(current - 1));
+    }
+    else if (input->KeyPressed(KEY_HOME)) SeekReplay(0);
+    else if (input->KeyPressed(KEY_END)) SeekReplay(events);
+    else if (input->KeyPressed(KEY_SPACE)) {
+        LockMutex(&mutex, LOCK_GAME);
+        EndMatch();
+        UnlockMutex(&mutex, LOCK_GAME);
+        screen = 1;
+    }
+}
+
+/**
+ * @brief Draws the replay scrubber in place of the instructions
+ */
+void Game::DrawScrubber() {
+    int events = (int)replay.events.size();
+    DrawTextEx("REPLAY", 950, 625, 20, DARKGRAY);
+    DrawLine(920, 650, 1180, 650, LIGHTGRAY);
+
+    float share = events > 0 ? (float)replayEvent / events : 0.0f;
+    DrawRectangleRec(REPLAY_BAR, Fade(LIGHTGRAY, 0.5f));
+    DrawRectangle((int)REPLAY_BAR.x, (int)REPLAY_BAR.y, (int)(REPLAY_BAR.width * share), (int)REPLAY_BAR.height,
+                  Fade(SEAT_COLORS[turn - 1], 0.6f));
+    DrawRectangleLinesEx(REPLAY_BAR, 1, DARKGRAY);
+    DrawCircle((int)(REPLAY_BAR.x + REPLAY_BAR.width * share), (int)(REPLAY_BAR.y + REPLAY_BAR.height / 2), 10, DARKGRAY);
+
+    int turns = replay.TurnCount();
+    int shown = replayEvent > 0 ? replay.TurnOf(replayEvent - 1) : 0;
+    DrawTextEx(TextFormat("Die %d / %d", replayEvent, events), 930, 700, 18, DARKGRAY);
+    DrawTextEx(TextFormat("Turn %d / %d", shown, turns), 1060, 700, 18, DARKGRAY);
+    DrawTextEx("Drag the bar to seek", 930, 740, 16, GRAY);
+    DrawTextEx("LEFT / RIGHT: one die", 930, 762, 16, GRAY);
+    DrawTextEx("UP / DOWN: one turn", 930, 784, 16, GRAY);
+    DrawTextEx("HOME / END: either end", 930, 806, 16, GRAY);
+    DrawTextEx("SPACE: back to the menu", 930, 828, 16, GRAY);
+}
+
 /**
  * @brief Draws text using the custom font
  * Falls back to default DrawText if custom font isn't loaded
  */
 void Game::DrawTextEx(const char* text, int x, int y, int fontSize, Color color) {
-    if (gameFont.texture.id != 0) {
-        ::DrawTextEx(gameFont, text, (Vector2){(float)x, (float)y}, fontSize, 1, color);
+    const Font& font = FontFor(fontSize);
+    if (font.texture.id != 0) {
+        ::DrawTextEx(font, text, (Vector2){(float)x, (float)y}, fontSize, 1, color);
     } else {
         DrawText(text, x, y, fontSize, color);
     }
@@ -178,19 +530,52 @@ void Game::DrawTextEx(const char* text, int x, int y, int fontSize, Color color)
  * @param color Text color
  */
 void DrawCenteredTextEx(Game* game, const char* text, int y, int fontSize, Color color) {
-    Vector2 textSize = MeasureTextEx(game->gameFont, text, fontSize, 1);
+    Vector2 textSize = MeasureTextEx(game->FontFor(fontSize), text, fontSize, 1);
     game->DrawTextEx(text, (Game::SCREEN_WIDTH - textSize.x) / 2, y, fontSize, color);
 }
 
+/**
+ * @brief Draws the board of the current match
+ * Boards without an image are drawn from their cell tables: each arm in its
+ * seat's color, safe squares marked, home columns filled and yards ringed
+ */
+void Game::DrawBoard() {
+    if (activeBoard == BOARD_CLASSIC) {
+        LudoBoard.Draw(0, 0, WHITE);
+        return;
+    }
+    const BoardGeometry& g = Board(activeBoard);
+    float cell = (float)g.cellSize;
+    float inset = cell - 2.0f;
+    DrawRectangle(0, 0, g.size, g.size, WHITE);
+    DrawCircle(g.size / 2, g.size / 2, (g.inner + 0.5f) * cell, Fade(LIGHTGRAY, 0.5f));
+
+    auto square = [&](BoardPoint p, float angle, Color fill) {
+        Rectangle r = {p.x + cell / 2, p.y + cell / 2, inset, inset};
+        DrawRectanglePro(r, {inset / 2, inset / 2}, angle, fill);
+    };
+    for (int a = 0; a < g.arms; a++) {
+        Color color = SEAT_COLORS[a];
+        for (int k = 0; k < g.armLength; k++) {
+            int c = a * g.armLength + k;
+            Color fill = k == g.start ? Fade(color, 0.7f) : g.IsSafe(c) ? LIGHTGRAY : Fade(LIGHTGRAY, 0.35f);
+            square(g.track[c], g.armAngle[a], fill);
+        }
+        for (int c = 1; c < g.lane; c++) {
+            square(g.home[a][c], g.armAngle[a], Fade(color, 0.5f));
+        }
+        for (int k = 0; k < numTokens; k++) {
+            Vector2 centre = {g.yard[a][k].x + cell / 2, g.yard[a][k].y + cell / 2};
+            DrawCircleV(centre, cell * 0.55f, Fade(color, 0.25f));
+        }
+    }
+}
+
 /**
  * @brief Draws the game scoreboard
  * Displays player scores, current turn, and dice values
- * @param p1 Score for player 1
- * @param p2 Score for player 2
- * @param p3 Score for player 3
- * @param p4 Score for player 4
  */
-void Game::DrawScore(int p1, int p2, int p3, int p4) {
+void Game::DrawScore() {
     // Draw scoreboard background
     DrawRectangle(900, 0, 300, SCREEN_HEIGHT, RAYWHITE);
     DrawRectangleLinesEx((Rectangle){900, 0, 300, (float)SCREEN_HEIGHT}, 2, LIGHTGRAY);
@@ -199,17 +584,21 @@ void Game::DrawScore(int p1, int p2, int p3, int p4) {
     DrawTextEx("SCOREBOARD", 950, 20, 30, DARKGRAY);
     DrawLine(920, 60, 1180, 60, LIGHTGRAY);
 
-    // Draw player scores with colored rectangles
-    const char* playerNames[] = {"RED", "GREEN", "YELLOW", "BLUE"};
-    int scores[] = {p1, p2, p3, p4};
-    Color colors[] = {RED, GREEN, YELLOW, BLUE};
+    // Draw player scores with colored rectangles; more seats share the same height
+    const char* const* playerNames = SEAT_NAMES;
+    const Color* colors = SEAT_COLORS;
+    int seats = Board(activeBoard).arms;
+    int spacing = seats <= 4 ? 50 : 200 / seats;
+    int boxHeight = spacing * 7 / 10;
+    int fontSize = seats <= 4 ? 20 : 14;
     
-    for (int i = 0; i < 4; i++) {
-        float yPos = 80 + i * 50;
-        DrawRectangle(920, (int)yPos, 240, 35, Fade(colors[i], 0.2f));
-        DrawRectangleLinesEx((Rectangle){920, yPos, 240, 35}, 1, colors[i]);
-        DrawTextEx(playerNames[i], 930, (int)yPos + 8, 20, colors[i]);
-        DrawTextEx(TextFormat("%d", scores[i]), 1120, (int)yPos + 8, 20, DARKGRAY);
+    for (int i = 0; i < seats; i++) {
+        float yPos = 80 + i * spacing;
+        int textY = (int)yPos + (boxHeight - fontSize + 1) / 2;
+        DrawRectangle(920, (int)yPos, 240, boxHeight, Fade(colors[i], 0.2f));
+        DrawRectangleLinesEx((Rectangle){920, yPos, 240, (float)boxHeight}, 1, colors[i]);
+        DrawTextEx(playerNames[i], 930, textY, fontSize, colors[i]);
+        DrawTextEx(TextFormat("%d", players[i].score), 1120, textY, fontSize, DARKGRAY);
     }
 
     // Draw current turn indicator
@@ -233,12 +622,53 @@ void Game::DrawScore(int p1, int p2, int p3, int p4) {
         }
     }
 
+    if (screen == 4) {
+        DrawScrubber();
+        return;
+    }
+
     // Draw instructions
     DrawRectangle(920, 620, 260, 70, Fade(LIGHTGRAY, 0.3f));
     DrawRectangleLinesEx((Rectangle){920, 620, 260, 70}, 1, DARKGRAY);
     DrawTextEx("INSTRUCTIONS", 950, 625, 20, DARKGRAY);
     DrawTextEx("Click dice to roll", 930, 650, 18, DARKGRAY);
     DrawTextEx("Click token to move", 930, 670, 18, DARKGRAY);
+
+    DrawLatency();
+}
+
+/**
+ * @brief Draws the input latency of each stage, from the live metrics
+ * Bounds are the histogram bucket holding the percentile, so they read as "at most"
+ */
+void Game::DrawLatency() {
+    DrawTextEx("INPUT LATENCY", 950, 710, 20, DARKGRAY);
+    DrawLine(920, 735, 1180, 735, LIGHTGRAY);
+
+    const char* names[3] = {"Click > state", "State > screen", "Click > screen"};
+    const MetricHistogram* stages[3] = {&metrics.inputLatency, &metrics.presentLatency, &metrics.clickToPhoton};
+    for (int i = 0; i < 3; i++) {
+        int y = 745 + i * 25;
+        DrawTextEx(names[i], 930, y, 16, DARKGRAY);
+        uint64_t p50 = stages[i]->Quantile(0.5), p95 = stages[i]->Quantile(0.95);
+        if (p50 == 0) {
+            DrawTextEx("-", 1080, y, 16, GRAY);
+        } else if (p95 == UINT64_MAX) {
+            DrawTextEx(TextFormat("%.1f / >1000", p50 / 1e6), 1080, y, 16, GRAY);
+        } else {
+            DrawTextEx(TextFormat("%.1f / %.1f", p50 / 1e6, p95 / 1e6), 1080, y, 16, GRAY);
+        }
+    }
+
+    // Frames presented before the result showed, over every measured click
+    uint64_t clicks = 0, frames = 0;
+    for (int i = 0; i <= Metrics::MAX_INPUT_FRAMES; i++) {
+        clicks += metrics.inputFrames[i].Get();
+        frames += metrics.inputFrames[i].Get() * i;
+    }
+    DrawTextEx("Frames to screen", 930, 820, 16, DARKGRAY);
+    DrawTextEx(clicks == 0 ? "-" : TextFormat("%.1f", (double)frames / clicks), 1080, 820, 16, GRAY);
+    DrawTextEx("p50 / p95 ms", 930, 845, 14, GRAY);
 }
 
 /**
@@ -275,7 +705,7 @@ void Game::DrawStartScreen() {
     DrawRectangleGradientH(ludoBox.x, ludoBox.y, ludoBox.width, ludoBox.height, 
                           Fade(BLUE, 0.2f), Fade(RED, 0.2f));
     DrawRectangleLinesEx(ludoBox, 3, DARKGRAY);
-    Vector2 ludoSize = MeasureTextEx(gameFont, "LUDO", 120, 1);
+    Vector2 ludoSize = MeasureTextEx(FontFor(120), "LUDO", 120, 1);
     DrawTextEx("LUDO", ludoBox.x + (ludoBox.width - ludoSize.x)/2, ludoBox.y + 10, 120, DARKGRAY);
 
     // Draw subtitle with decorative line
@@ -297,23 +727,32 @@ void Game::DrawStartScreen() {
     }
 
     // Draw token selection hint
-    DrawTextEx("Press 1-4 to select", tokenBox.x + 150, tokenBox.y + 120, 25, GRAY);
+    DrawTextEx(TextFormat("Press 1-%d to select", RULES_MAX_TOKENS), tokenBox.x + 150, tokenBox.y + 120, 25, GRAY);
+
+    // Handle bot opponent toggle
+    DrawTextEx(TextFormat("Press B for computer opponents: %s", botSeats ? "ON" : "OFF"),
+               tokenBox.x + 70, tokenBox.y + 160, 22, botSeats ? DARKGREEN : GRAY);
+    if (input->KeyPressed('B')) botSeats = !botSeats;
+
+    // Handle board selection; boards loaded with --board are in the cycle too
+    DrawTextEx(TextFormat("Press G to change board: %d players", Board(selectedBoard).arms),
+               tokenBox.x + 120, tokenBox.y + 184, 16, GRAY);
+    if (input->KeyPressed('G')) selectedBoard = (selectedBoard + 1) % BoardCount();
 
     // Handle token selection
-    if (IsKeyPressed('1')) numTokens = 1;
-    if (IsKeyPressed('2')) numTokens = 2;
-    if (IsKeyPressed('3')) numTokens = 3;
-    if (IsKeyPressed('4')) numTokens = 4;
+    for (int k = 1; k <= RULES_MAX_TOKENS; k++) {
+        if (input->KeyPressed('0' + k)) numTokens = k;
+    }
 
     // Draw start button with animation
     Rectangle startBtn = {450, 600, 300, 80};
-    Color btnColor = CheckCollisionPointRec(GetMousePosition(), startBtn) ? 
+    Color btnColor = CheckCollisionPointRec(MousePosition(), startBtn) ? 
                     Fade(GREEN, 0.7f) : Fade(GREEN, 0.5f);
     
     DrawRectangle(startBtn.x, startBtn.y, startBtn.width, startBtn.height, btnColor);
     DrawRectangleLinesEx(startBtn, 2, DARKGREEN);
     
-    Vector2 startSize = MeasureTextEx(gameFont, "START", 40, 1);
+    Vector2 startSize = MeasureTextEx(FontFor(40), "START", 40, 1);
     DrawTextEx("START", 
               startBtn.x + (startBtn.width - startSize.x)/2, 
               startBtn.y + (startBtn.height - startSize.y)/2, 
@@ -325,18 +764,29 @@ void Game::DrawStartScreen() {
     DrawTextEx("Amna , Shuja ,Samra", 120, SCREEN_HEIGHT - 30, 20, MAROON);
 
     // Handle start button click
-    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-        if (CheckCollisionPointRec(GetMousePosition(), startBtn)) {
-            if (numTokens <= 4 && numTokens >= 1) {
-                screen = 2;
-                LudoGrid = new std::tuple<int, int, int>*[4];
-                for (int i = 0; i < 4; i++) {
-                    LudoGrid[i] = new std::tuple<int, int, int>[numTokens];
-                }
-                InitializePlayers();
+    if (input->MousePressed()) {
+        if (CheckCollisionPointRec(MousePosition(), startBtn)) {
+            if (numTokens <= RULES_MAX_TOKENS && numTokens >= 1) {
+                Rematch();
             }
         }
     }
+
+    // Resume the match saved when the window was last closed
+    if (FileExists(savePath.c_str())) {
+        DrawTextEx("Press R to resume saved match", tokenBox.x + 110, tokenBox.y + 295, 22, GRAY);
+        if (input->KeyPressed('R') && !LoadSnapshot(*this, savePath.c_str())) {
+            std::cout << "Failed to load snapshot: " << savePath << std::endl;
+        }
+    }
+
+    // Watch the match recorded last
+    if (FileExists(replayPath.c_str())) {
+        DrawTextEx("Press P to watch the last match", tokenBox.x + 105, tokenBox.y + 320, 22, GRAY);
+        if (input->KeyPressed('P') && !OpenReplay(replayPath.c_str())) {
+            std::cout << "Failed to open replay: " << replayPath << std::endl;
+        }
+    }
 }
 
 /**
@@ -369,7 +819,7 @@ void Game::DrawWinScreen() {
         255
     };
     
-    Vector2 gameOverSize = MeasureTextEx(gameFont, "GAME OVER!", 100, 1);
+    Vector2 gameOverSize = MeasureTextEx(FontFor(100), "GAME OVER!", 100, 1);
     DrawTextEx("GAME OVER!", 
               titleBox.x + (titleBox.width - gameOverSize.x)/2, 
               titleBox.y + (titleBox.height - gameOverSize.y)/2, 
@@ -377,16 +827,16 @@ void Game::DrawWinScreen() {
 
     // Draw "WINNERS" text with decorative lines
     DrawLineEx((Vector2){300, 180}, (Vector2){900, 180}, 3, GOLD);
-    Vector2 winnersSize = MeasureTextEx(gameFont, "WINNERS", 60, 1);
+    Vector2 winnersSize = MeasureTextEx(FontFor(60), "WINNERS", 60, 1);
     DrawTextEx("WINNERS", (SCREEN_WIDTH - winnersSize.x)/2, 200, 60, DARKGRAY);
     DrawLineEx((Vector2){300, 280}, (Vector2){900, 280}, 3, GOLD);
 
     // Draw winners list with enhanced styling
-    const char* playerNames[] = {"RED", "GREEN", "YELLOW", "BLUE"};
-    Color playerColors[] = {RED, GREEN, YELLOW, BLUE};
+    const char* const* playerNames = SEAT_NAMES;
+    const Color* playerColors = SEAT_COLORS;
     const char* trophies[] = {"🏆", "🥈", "🥉", "4th"};
     
-    for (int i = 0; i < winners.size() && i < 4; i++) {
+    for (int i = 0; i < (int)winners.size() && i < 4; i++) {
         float yPos = 320 + (i * 120);
         float time = GetTime() * 2;
         float scale = 1.0f + 0.1f * sin(time + i);
@@ -420,16 +870,23 @@ void Game::DrawWinScreen() {
 
     // Draw return to menu hint with blinking effect
     float blinkTime = sin(GetTime() * 3) * 0.5f + 0.5f;
-    DrawTextEx("Press SPACE to return to menu", 
-              450, SCREEN_HEIGHT - 50, 
-              25, Fade(DARKGRAY, blinkTime));
+    DrawCenteredTextEx(this, "Press SPACE to return to menu, ENTER for a rematch",
+                       SCREEN_HEIGHT - 50, 25, Fade(DARKGRAY, blinkTime));
+
+    // Same tokens and seats again, or back to the menu to change them
+    if (input->KeyPressed(KEY_ENTER)) {
+        Rematch();
+    }
+    else if (input->KeyPressed(KEY_SPACE)) {
+        screen = 1;
+    }
 }
 
 /**
  * @brief Draws the current dice face
  */
 void Game::DrawDice() {
-    DrawTexture(Dice[dice - 1], 990, 500, WHITE);
+    Dice[dice - 1].Draw(990, 500, WHITE);
 }
 
 /**
@@ -437,69 +894,97 @@ void Game::DrawDice() {
  * Handles player turns, movement, and game completion
  */
 void Game::Update() {
-    if (screen == 2) {
-        DrawTexture(LudoBoard, 0, 0, WHITE);
-        DrawScore(P1.score, P2.score, P3.score, P4.score);
+    // The replay seeks before drawing, so the frame shows the position it asked for
+    if (screen == 4) UpdateReplay();
+    if (screen == 2 || screen == 4) {
+        DrawBoard();
+        DrawScore();
         DrawDice();
 
         int count = 0;
         int index = 0;
 
-        // Handle player 1
-        if (!P1.completed) P1.Start();
-        else if (!FinishedThreads[0]) {
-            pthread_cancel(th[0]);
-            diceVal.resize(3);
-            std::fill(diceVal.begin(), diceVal.end(), 0);
-            turn = getTurn();
-            movePlayer = false;
-            FinishedThreads[0] = true;
-        }
-
-        // Handle player 2
-        if (!P2.completed) P2.Start();
-        else if (!FinishedThreads[1]) {
-            pthread_cancel(th[1]);
-            turn = getTurn();
-            movePlayer = false;
-            diceVal.resize(3);
-            std::fill(diceVal.begin(), diceVal.end(), 0);
-            FinishedThreads[1] = true;
-        }
+        // Keep the scheduler thread out while finished players are retired
+        LockMutex(&mutex, LOCK_GAME);
 
-        // Handle player 3
-        if (!P3.completed) P3.Start();
-        else if (!FinishedThreads[2]) {
-            pthread_cancel(th[2]);
-            turn = getTurn();
-            movePlayer = false;
-            diceVal.resize(3);
-            std::fill(diceVal.begin(), diceVal.end(), 0);
-            FinishedThreads[2] = true;
-        }
-
-        // Handle player 4
-        if (!P4.completed) P4.Start();
-        else if (!FinishedThreads[3]) {
-            pthread_cancel(th[3]);
-            diceVal.resize(3);
-            std::fill(diceVal.begin(), diceVal.end(), 0);
-            turn = getTurn();
-            movePlayer = false;
-            FinishedThreads[3] = true;
+        // Retire players as they finish and hand the turn on; a replay only draws
+        int seats = Board(activeBoard).arms;
+        for (int p = 0; p < seats && screen == 2; p++) {
+            if (!players[p].completed) players[p].Start();
+            else if (!FinishedThreads[p]) {
+                // A player can finish with dice left; drop them so the next seat can roll
+                diceVal.resize(3);
+                std::fill(diceVal.begin(), diceVal.end(), 0);
+                turn = getTurn();
+                movePlayer = false;
+                moveDice = true;
+                diceCount = 0;
+                FinishedThreads[p] = true;
+            }
         }
 
         // Check for game completion
-        for (int g = 0; g < 4; g++) {
+        for (int g = 0; g < seats; g++) {
             if (FinishedThreads[g] == true)
                 count++;
             else
                 index = g;
         }
 
-        if (count >= 3) {
+        // Every token on the board, the last one walking home included, in one draw call
+        tokenBatch.Clear();
+        for (int p = 0; p < seats; p++) {
+            players[p].draw(tokenBatch);
+        }
+        tokenBatch.Draw((float)Board(activeBoard).cellSize);
+
+        // Hints read a copy, so working them out for a new position does not hold up the rules
+        LudoState state;
+        if (showHints) {
+            state = matchState;
+            state.turn = (uint8_t)(turn - 1);
+            state.homeMask = 0;
+            for (int p = 0; p < seats; p++) {
+                if (players[p].tokens[0].canGoHome) state.homeMask |= (uint8_t)(1 << p);
+            }
+        }
+
+        if (screen == 2 && count >= seats - 1) {
             winners.push_back(index + 1);
             screen = 3;
+            SaveReplay();
+            // Stop the last player's coroutine and release the board; the win screen only needs winners
+            EndMatch();
+        }
+        UnlockMutex(&mutex, LOCK_GAME);
+
+        if (input->KeyPressed('H')) showHints = !showHints;
+        else if (showHints && screen != 3) DrawHints(state);
+    }
+}
+
+/**
+ * @brief Draws the estimated capture and home odds over every token
+ * Red estimates the chance of being captured before the owner's next turn,
+ * green bounds the chance of finishing within HINT_HOME_TURNS turns; both
+ * are marked '~' as they are not exact, and zero odds are left out
+ */
+void Game::DrawHints(const LudoState& s) {
+    const TokenHint (*odds)[RULES_MAX_TOKENS] = hints.Get(s);
+    const BoardGeometry& g = Board(s.board);
+    for (int p = 0; p < s.numPlayers; p++) {
+        for (int t = 0; t < s.numTokens; t++) {
+            int spot = g.Spot(p, t, s.pos[p][t]);
+            if (spot < 0) continue;
+            BoardPoint at = g.SpotPixel(spot);
+            int y = (int)at.y - 12;
+            if (odds[p][t].captured >= 0.005f) {
+                DrawTextEx(TextFormat("~%d%%", (int)(odds[p][t].captured * 100 + 0.5f)), (int)at.x, y, 12, MAROON);
+                y -= 12;
+            }
+            if (odds[p][t].home >= 0.005f) {
+                DrawTextEx(TextFormat("~%d%%", (int)(odds[p][t].home * 100 + 0.5f)), (int)at.x, y, 12, DARKGREEN);
+            }
         }
     }
 }
@@ -509,26 +994,76 @@ void Game::Update() {
  * Handles drawing and updating game state
  */
 void Game::Run() {
-    while (!WindowShouldClose()) {
+    uint64_t lastFrame = MetricsNowNs();
+    double lastExport = GetTime();
+    while (!WindowShouldClose() && !input->CloseRequested()) {
+        input->BeginFrame(frame++, screen);
+
+        // Input latency runs from here to the roll or move the click triggers,
+        // and on to the end of the first frame that draws it
+        if (screen == 2 && input->MousePressed()) {
+            NoteInputCaptured();
+            LatchInput();
+        }
+
+        // In lockstep the rules advance exactly one tick per frame, after this frame's input
+        if (schedulerThread.lockstep) {
+            schedulerThread.Step();
+        }
+
+        // Scaled assets are only rebuilt when the window size or DPI changes
+        if (viewport.Update()) {
+            RescaleAssets();
+        }
+
+        uint64_t drawStart = MetricsNowNs();
         BeginDrawing();
         ClearBackground(RAYWHITE);
+        BeginMode2D(viewport.Camera());
 
+        int drawn = screen;
         if (screen == 1) {
             DrawStartScreen();
         }
-        else if (screen == 2) {
+        else if (screen == 2 || screen == 4) {
             Update();
         }
         else {
             DrawWinScreen();
         }
 
+        EndMode2D();
         EndDrawing();
+
+        uint64_t now = MetricsNowNs();
+        NoteFramePresented(drawStart, now);
+        metrics.frameTime.Record(now - lastFrame);
+        lastFrame = now;
+        if (!metricsPath.empty() && GetTime() - lastExport >= METRICS_EXPORT_SECONDS) {
+            metrics.Export(metricsPath.c_str());
+            lastExport = GetTime();
+        }
+
+        // First playable frame of a new match
+        if (drawn == 2 && matchRequested >= 0.0) {
+            std::cout << "Match ready in " << (GetTime() - matchRequested) * 1000.0 << " ms" << std::endl;
+            matchRequested = -1.0;
+        }
     }
 
-    // Clean up threads
-    pthread_join(th[0], NULL);
-    pthread_join(th[1], NULL);
-    pthread_join(th[2], NULL);
-    pthread_join(th[3], NULL);
+    // Cooperative, bounded stop; the match is only saved and released once the thread is gone
+    if (StopScheduler()) {
+        if (screen == 2) {
+            // Save an unfinished match so it can be resumed later
+            if (!SaveSnapshot(*this, savePath.c_str())) {
+                std::cout << "Failed to save snapshot: " << savePath << std::endl;
+            }
+            SaveReplay();
+        }
+        EndMatch();
+    }
+
+    if (!metricsPath.empty() && !metrics.Export(metricsPath.c_str())) {
+        std::cout << "Failed to write metrics: " << metricsPath << std::endl;
+    }
 } 
\ No newline at end of file
@@ -0,0 +1,169 @@
+/**
+ * @file Hint.cpp
+ * @brief Estimated capture and home probabilities per token, memoized by board state
+ */
+
+#include "../include/Hint.h"
+#include <bit>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Dice of one turn outcome under a rule variant
+ * TURN_DICE is for the classic rules; where a third six is played, the
+ * forfeited outcome plays three sixes instead
+ * @return Number of dice to play
+ */
+template <class R>
+int OutcomeDice(int outcome, int* dice) {
+    const TurnDice& o = TURN_DICE[outcome];
+    if (o.count == 0 && !R::TRIPLE_SIX_FORFEITS) {
+        dice[0] = dice[1] = dice[2] = 6;
+        return RULES_MAX_DICE;
+    }
+    memcpy(dice, o.dice, sizeof(o.dice));
+    return o.count;
+}
+
+/**
+ * @brief Bit per opponent token captured on some order of choices of a dice queue
+ * @return Bit player * RULES_MAX_TOKENS + token for every token that can be sent home
+ */
+template <class R>
+uint64_t CaptureMask(const LudoState& s, int player, const int* dice, int numDice) {
+    if (numDice == 0) return 0;
+
+    LudoMove moves[RULES_MAX_TOKENS];
+    int count = GenerateMoves<R>(s, player, dice, 1, moves, RULES_MAX_TOKENS);
+    if (count == 0) return CaptureMask<R>(s, player, dice + 1, numDice - 1);
+
+    uint64_t mask = 0;
+    for (int i = 0; i < count; i++) {
+        LudoState next = s;
+        ApplyMove<R>(next, player, moves[i]);
+        if (moves[i].flags & MOVE_CAPTURE) {
+            for (int p = 0; p < s.numPlayers; p++) {
+                for (int t = 0; t < s.numTokens; t++) {
+                    if (s.pos[p][t] != POS_YARD && next.pos[p][t] == POS_YARD)
+                        mask |= 1ULL << (p * RULES_MAX_TOKENS + t);
+                }
+            }
+        }
+        mask |= CaptureMask<R>(next, player, dice + 1, numDice - 1);
+    }
+    return mask;
+}
+
+/**
+ * @brief Best probability of finishing after a turn's dice, one die at a time
+ * Every die either moves the token or is left to another token
+ * @param dice The turn's dice; dice k and later are still to play
+ * @param after Probability of finishing from each position once the turn is over
+ */
+template <class R>
+double TurnReach(const BoardGeometry& g, int pos, const int (&dice)[RULES_MAX_DICE], int k, int numDice,
+                 bool canGoHome, const double* after) {
+    if (k >= numDice || k >= RULES_MAX_DICE) return after[pos];
+    double best = TurnReach<R>(g, pos, dice, k + 1, numDice, canGoHome, after);
+    int to = MoveTarget<R>(g, pos, dice[k], canGoHome);
+    if (to >= 0) {
+        double moved = TurnReach<R>(g, to, dice, k + 1, numDice, canGoHome, after);
+        if (moved > best) best = moved;
+    }
+    return best;
+}
+
+/** @brief FNV-1a over the bytes of a state */
+uint32_t HashState(const LudoState& s) {
+    const uint8_t* bytes = (const uint8_t*)&s;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < sizeof(s); i++) {
+        h = (h ^ bytes[i]) * 16777619u;
+    }
+    return h;
+}
+
+} // namespace
+
+HintTable::HintTable() : cache{}, last(nullptr), homeBoard(-1), home{}, computed(0) {}
+
+const TokenHint (*HintTable::Get(const LudoState& s))[RULES_MAX_TOKENS] {
+    // The usual case: the same state as the previous frame
+    if (last != nullptr && memcmp(&last->key, &s, sizeof(s)) == 0) return last->hints;
+
+    Entry& e = cache[HashState(s) % CACHE_SLOTS];
+    if (!e.used || memcmp(&e.key, &s, sizeof(s)) != 0) {
+        e.key = s;
+        e.used = true;
+        Compute(e);
+    }
+    last = &e;
+    return e.hints;
+}
+
+void HintTable::BuildHomeTable(int board) {
+    const BoardGeometry& g = Board(board);
+    for (int canGoHome = 0; canGoHome < 2; canGoHome++) {
+        // reach[pos] is the probability of finishing within k turns, for k = 0..HINT_HOME_TURNS
+        double reach[BOARD_MAX_POS] = {}, next[BOARD_MAX_POS];
+        reach[g.finished] = 1.0;
+        for (int k = 1; k <= HINT_HOME_TURNS; k++) {
+            for (int pos = 0; pos <= g.finished; pos++) {
+                double p = 0.0;
+                for (int o = 0; o < TURN_DICE_COUNT; o++) {
+                    int dice[RULES_MAX_DICE];
+                    int n = OutcomeDice<GameRules>(o, dice);
+                    p += TURN_DICE[o].prob * TurnReach<GameRules>(g, pos, dice, 0, n, canGoHome, reach);
+                }
+                next[pos] = p;
+            }
+            memcpy(reach, next, sizeof(double) * (g.finished + 1));
+        }
+        for (int pos = 0; pos <= g.finished; pos++) {
+            home[canGoHome][pos] = (float)reach[pos];
+        }
+    }
+    homeBoard = board;
+}
+
+void HintTable::Compute(Entry& e) {
+    const LudoState& s = e.key;
+    if (homeBoard != s.board) BuildHomeTable(s.board);
+    computed++;
+
+    // Chance each opponent cannot capture a token, multiplied over opponents
+    double safe[RULES_MAX_PLAYERS][RULES_MAX_TOKENS];
+    for (int p = 0; p < s.numPlayers; p++) {
+        for (int t = 0; t < s.numTokens; t++) safe[p][t] = 1.0;
+    }
+    for (int q = 0; q < s.numPlayers; q++) {
+        double exposed[RULES_MAX_PLAYERS * RULES_MAX_TOKENS] = {};
+        for (int o = 0; o < TURN_DICE_COUNT; o++) {
+            int dice[RULES_MAX_DICE];
+            int n = OutcomeDice<GameRules>(o, dice);
+            uint64_t mask = CaptureMask<GameRules>(s, q, dice, n);
+            while (mask != 0) {
+                int bit = std::countr_zero(mask);
+                exposed[bit] += TURN_DICE[o].prob;
+                mask &= mask - 1;
+            }
+        }
+        for (int p = 0; p < s.numPlayers; p++) {
+            if (p == q) continue;
+            for (int t = 0; t < s.numTokens; t++) {
+                safe[p][t] *= 1.0 - exposed[p * RULES_MAX_TOKENS + t];
+            }
+        }
+    }
+
+    const BoardGeometry& g = Board(s.board);
+    for (int p = 0; p < s.numPlayers; p++) {
+        bool canGoHome = !GameRules::CAPTURE_TO_ENTER_HOME || (s.homeMask & (1 << p));
+        for (int t = 0; t < s.numTokens; t++) {
+            int pos = s.pos[p][t];
+            e.hints[p][t].captured = (float)(1.0 - safe[p][t]);
+            e.hints[p][t].home = pos <= g.finished ? home[canGoHome][pos] : 0.0f;
+        }
+    }
+}
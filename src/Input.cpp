@@ -0,0 +1,189 @@
+/**
+ * @file Input.cpp
+ * @brief Live and scripted input providers
+ */
+
+#include "../include/Input.h"
+#include "../include/Viewport.h"
+#include "../include/Utils.h"
+#include "../include/Metrics.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+extern pthread_mutex_t mutex;
+
+bool RaylibInput::MousePressed() {
+    return IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+}
+
+bool RaylibInput::MouseDown() {
+    return IsMouseButtonDown(MOUSE_LEFT_BUTTON);
+}
+
+Vector2 RaylibInput::MousePosition() {
+    return viewport.ToLogical(GetMousePosition());
+}
+
+bool RaylibInput::KeyPressed(int key) {
+    return IsKeyPressed(key);
+}
+
+namespace {
+
+/**
+ * @brief Reads a key: one character, a key name or a key code
+ * @return Key code, or -1
+ */
+int ParseKey(const std::string& word) {
+    if (word.size() == 1) return (unsigned char)word[0];
+    if (word == "ENTER") return KEY_ENTER;
+    if (word == "SPACE") return KEY_SPACE;
+    if (word == "ESCAPE") return KEY_ESCAPE;
+    if (word == "LEFT") return KEY_LEFT;
+    if (word == "RIGHT") return KEY_RIGHT;
+    char* end;
+    long code = strtol(word.c_str(), &end, 10);
+    return *end == '\0' && code > 0 ? (int)code : -1;
+}
+
+} // namespace
+
+ScriptedInput::ScriptedInput()
+    : pressed(false), position{0.0f, 0.0f}, keys{}, keyCount(0), closing(false), nextToken(0) {}
+
+bool ScriptedInput::Load(const char* path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cout << "Cannot open input script " << path << std::endl;
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    return Parse(text.str().c_str());
+}
+
+bool ScriptedInput::Parse(const char* text) {
+    events.clear();
+    std::istringstream in(text);
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream words(line);
+        std::string when, action;
+        if (!(words >> when)) continue;
+
+        Event e = {};
+        bool ok = true;
+        if (when == "every") {
+            e.trigger = EVERY_FRAMES;
+            ok = (bool)(words >> e.frame) && e.frame > 0;
+        } else if (when == "win") {
+            e.trigger = ON_WIN;
+        } else {
+            e.trigger = AT_FRAME;
+            char* end;
+            e.frame = strtol(when.c_str(), &end, 10);
+            ok = *end == '\0' && e.frame >= 0;
+        }
+
+        ok = ok && (bool)(words >> action);
+        if (ok && e.trigger == EVERY_FRAMES && isdigit((unsigned char)action[0])) {
+            // Optional phase within the period, so repeated actions can take turns
+            e.offset = atol(action.c_str()) % e.frame;
+            ok = (bool)(words >> action);
+        }
+        if (ok && action == "key") {
+            std::string key;
+            e.action = ACTION_KEY;
+            ok = (bool)(words >> key) && (e.key = ParseKey(key)) > 0;
+        } else if (ok && action == "click") {
+            e.action = ACTION_CLICK;
+            ok = (bool)(words >> e.at.x >> e.at.y);
+        } else if (ok && action == "token") {
+            e.action = ACTION_TOKEN;
+        } else if (ok && action == "quit") {
+            e.action = ACTION_QUIT;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cout << "Input script line " << lineNo << ": cannot read '" << line << "'" << std::endl;
+            return false;
+        }
+        events.push_back(e);
+    }
+    return true;
+}
+
+void ScriptedInput::BeginFrame(long frame, int screen) {
+    pressed = false;
+    keyCount = 0;
+    for (Event& e : events) {
+        if (e.trigger == AT_FRAME) {
+            if (frame == e.frame) Fire(e);
+        } else if (e.trigger == EVERY_FRAMES) {
+            if (screen == 2 && frame % e.frame == e.offset) Fire(e);
+        } else if (screen != 3) {
+            e.fired = false;
+        } else if (!e.fired) {
+            e.fired = true;
+            Fire(e);
+        }
+    }
+}
+
+bool ScriptedInput::KeyPressed(int key) {
+    for (int i = 0; i < keyCount; i++) {
+        if (keys[i] == key) return true;
+    }
+    return false;
+}
+
+void ScriptedInput::Fire(const Event& e) {
+    switch (e.action) {
+    case ACTION_KEY:
+        if (keyCount < MAX_KEYS) keys[keyCount++] = e.key;
+        break;
+    case ACTION_CLICK:
+        pressed = true;
+        position = e.at;
+        break;
+    case ACTION_TOKEN:
+        pressed = NextTokenPosition(position) || pressed;
+        break;
+    case ACTION_QUIT:
+        closing = true;
+        break;
+    }
+}
+
+bool ScriptedInput::NextTokenPosition(Vector2& out) {
+    // spotTokens is written by the logic tick, under the game mutex
+    LockMutex(&mutex, LOCK_GAME);
+    bool found = false;
+    if (LudoGrid != nullptr && numTokens > 0) {
+        const BoardGeometry& g = Board(activeBoard);
+        for (int tries = 0; tries < numTokens && !found; tries++) {
+            int k = nextToken++ % numTokens;
+            for (int s = 0; s < BOARD_MAX_SPOTS; s++) {
+                if (spotTokens[s][0] & (1 << k)) {
+                    BoardPoint p = g.SpotPixel(s);
+                    out = {p.x + g.cellSize / 2.0f, p.y + g.cellSize / 2.0f};
+                    found = true;
+                    break;
+                }
+            }
+        }
+    }
+    UnlockMutex(&mutex, LOCK_GAME);
+    return found;
+}
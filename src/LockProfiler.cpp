@@ -0,0 +1,157 @@
+/**
+ * @file LockProfiler.cpp
+ * @brief Call-site attribution and lock-order checking for the game mutexes
+ */
+
+#include "../include/LockProfiler.h"
+#include <atomic>
+#include <cstring>
+#include <pthread.h>
+
+namespace {
+
+const int MAX_SITES = 64;
+
+/** @brief Statistics for one source line that takes one lock */
+struct LockSite {
+    const char* file;
+    unsigned line;
+    MetricLockId lock;
+    MetricCounter acquisitions;
+    MetricCounter orderViolations;      ///< Taken while a lock later in the order was held
+    MetricHistogram wait;
+    MetricHistogram hold;
+    std::atomic<uint64_t> maxWaitNs{0};
+};
+
+std::atomic<bool> enabled{false};
+LockSite sites[MAX_SITES];
+std::atomic<int> siteCount{0};
+pthread_mutex_t siteLock = PTHREAD_MUTEX_INITIALIZER;
+MetricCounter orderEdges[LOCK_COUNT][LOCK_COUNT];   ///< [held][taken] nested acquisitions
+
+/** @brief Game mutexes held by this thread, in acquisition order */
+thread_local MetricLockId heldLocks[LOCK_COUNT];
+thread_local int heldDepth = 0;
+
+/**
+ * @brief Finds or registers the site for a call location
+ * Sites are only ever appended, so readers scan without the lock
+ */
+int FindSite(MetricLockId id, const std::source_location& where) {
+    int n = siteCount.load(std::memory_order_acquire);
+    for (int i = 0; i < n; i++) {
+        if (sites[i].line == where.line() && sites[i].lock == id && sites[i].file == where.file_name())
+            return i;
+    }
+
+    pthread_mutex_lock(&siteLock);
+    int i = 0;
+    n = siteCount.load(std::memory_order_relaxed);
+    while (i < n && !(sites[i].line == where.line() && sites[i].lock == id && sites[i].file == where.file_name()))
+        i++;
+    if (i == n && n < MAX_SITES) {
+        sites[n].file = where.file_name();
+        sites[n].line = where.line();
+        sites[n].lock = id;
+        siteCount.store(n + 1, std::memory_order_release);
+    }
+    pthread_mutex_unlock(&siteLock);
+    return i < MAX_SITES ? i : -1;
+}
+
+const char* BaseName(const char* path) {
+    const char* slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+/** @brief Upper bound of the bucket holding the q-th sample, in microseconds */
+double QuantileUs(const MetricHistogram& h, double q) {
+    uint64_t total = h.count.load(std::memory_order_relaxed);
+    if (total == 0) return 0.0;
+    uint64_t rank = (uint64_t)(q * (total - 1)) + 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < MetricHistogram::BUCKETS; b++) {
+        seen += h.counts[b].load(std::memory_order_relaxed);
+        if (seen >= rank) return MetricHistogram::BOUNDS_NS[b] / 1e3;
+    }
+    return MetricHistogram::BOUNDS_NS[MetricHistogram::BUCKETS - 1] / 1e3;
+}
+
+} // namespace
+
+void EnableLockProfiling(bool on) {
+    enabled.store(on, std::memory_order_relaxed);
+}
+
+bool LockProfilingEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+int ProfileLockAcquired(MetricLockId id, uint64_t waitNs, const std::source_location& where) {
+    int s = FindSite(id, where);
+    bool violation = false;
+    for (int i = 0; i < heldDepth; i++) {
+        orderEdges[heldLocks[i]][id].Add();
+        if (heldLocks[i] >= id) violation = true;
+    }
+    if (heldDepth < LOCK_COUNT) heldLocks[heldDepth++] = id;
+    if (s < 0) return s;
+
+    LockSite& site = sites[s];
+    site.acquisitions.Add();
+    site.wait.Record(waitNs);
+    if (violation) site.orderViolations.Add();
+    uint64_t max = site.maxWaitNs.load(std::memory_order_relaxed);
+    while (waitNs > max && !site.maxWaitNs.compare_exchange_weak(max, waitNs, std::memory_order_relaxed)) {}
+    return s;
+}
+
+void ProfileLockReleased(MetricLockId id, int site, uint64_t holdNs) {
+    // Unlock order need not mirror lock order, so remove wherever it sits
+    for (int i = heldDepth - 1; i >= 0; i--) {
+        if (heldLocks[i] == id) {
+            for (int j = i; j < heldDepth - 1; j++) heldLocks[j] = heldLocks[j + 1];
+            heldDepth--;
+            break;
+        }
+    }
+    if (site >= 0) sites[site].hold.Record(holdNs);
+}
+
+void WriteLockProfile(FILE* f) {
+    int n = siteCount.load(std::memory_order_acquire);
+    fprintf(f, "Lock profile (microseconds; p50/p99 are bucket upper bounds)\n");
+    for (int lock = 0; lock < LOCK_COUNT; lock++) {
+        fprintf(f, "%s\n", MetricLockName((MetricLockId)lock));
+        for (int i = 0; i < n; i++) {
+            const LockSite& s = sites[i];
+            if (s.lock != lock) continue;
+            fprintf(f, "  %-18s:%-4u %8llu acq  wait p50 %7.1f p99 %7.1f max %9.1f  hold p50 %7.1f p99 %7.1f  total wait %.3f ms",
+                    BaseName(s.file), s.line, (unsigned long long)s.acquisitions.Get(),
+                    QuantileUs(s.wait, 0.5), QuantileUs(s.wait, 0.99),
+                    s.maxWaitNs.load(std::memory_order_relaxed) / 1e3,
+                    QuantileUs(s.hold, 0.5), QuantileUs(s.hold, 0.99),
+                    s.wait.sumNs.load(std::memory_order_relaxed) / 1e6);
+            if (s.orderViolations.Get() != 0)
+                fprintf(f, "  ORDER VIOLATIONS %llu", (unsigned long long)s.orderViolations.Get());
+            fprintf(f, "\n");
+        }
+    }
+
+    fprintf(f, "Nested acquisitions (held -> taken)\n");
+    for (int a = 0; a < LOCK_COUNT; a++) {
+        for (int b = 0; b < LOCK_COUNT; b++) {
+            uint64_t count = orderEdges[a][b].Get();
+            if (count == 0) continue;
+            const char* held = MetricLockName((MetricLockId)a);
+            const char* taken = MetricLockName((MetricLockId)b);
+            fprintf(f, "  %s -> %s: %llu%s\n", held, taken, (unsigned long long)count,
+                    a >= b ? "  (against mutex -> mutexDice -> mutexTurn)" : "");
+            if (a < b && orderEdges[b][a].Get() != 0)
+                fprintf(f, "  inconsistent order between %s and %s\n", held, taken);
+        }
+    }
+    if (n == MAX_SITES)
+        fprintf(f, "Site table full; later call sites were not attributed\n");
+}
@@ -0,0 +1,43 @@
+/**
+ * @file MatchArena.cpp
+ * @brief Per-match bump allocator
+ */
+
+#include "../include/MatchArena.h"
+#include "../include/Token.h"
+#include <cstdint>
+#include <cstdlib>
+#include <tuple>
+
+MatchArena::MatchArena() : buffer(nullptr), capacity(0), used(0) {}
+
+MatchArena::~MatchArena() {
+    free(buffer);
+}
+
+size_t MatchArena::MatchBytes(int players, int tokens) {
+    size_t bytes = players * sizeof(std::tuple<int, int, int>*) +
+                   players * tokens * (sizeof(std::tuple<int, int, int>) + sizeof(Token));
+    // Worst-case alignment padding in front of every block: grid rows, grid cells and tokens per player
+    int blocks = 1 + 2 * players;
+    return bytes + blocks * alignof(std::max_align_t);
+}
+
+bool MatchArena::Reserve(size_t bytes) {
+    if (bytes <= capacity) return true;
+    if (used != 0) return false;
+    char* grown = (char*)realloc(buffer, bytes);
+    if (grown == nullptr) return false;
+    buffer = grown;
+    capacity = bytes;
+    return true;
+}
+
+void* MatchArena::Allocate(size_t bytes, size_t align) {
+    uintptr_t base = (uintptr_t)buffer;
+    uintptr_t start = (base + used + align - 1) & ~(uintptr_t)(align - 1);
+    size_t end = (size_t)(start - base) + bytes;
+    if (buffer == nullptr || end > capacity) return nullptr;
+    used = end;
+    return (void*)start;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file Metrics.cpp
+ * @brief Atomic counters and histograms with Prometheus text export
+ */
+
+#include "../include/Metrics.h"
+#include "../include/LockProfiler.h"
+#include <chrono>
+#include <string>
+
+Metrics metrics;
+
+const uint64_t MetricHistogram::BOUNDS_NS[MetricHistogram::BUCKETS] = {
+    1000, 5000, 10000, 50000, 100000, 500000,
+    1000000, 2500000, 5000000, 10000000, 16700000, 25000000,
+    50000000, 100000000, 250000000, 1000000000
+};
+
+namespace {
+
+const char* const LOCK_NAMES[LOCK_COUNT] = { "mutex", "mutexDice", "mutexTurn" };
+
+// Acquisition time and profiler site of each game mutex; only written by the thread holding it
+uint64_t acquiredAtNs[LOCK_COUNT];
+int heldSite[LOCK_COUNT] = { -1, -1, -1 };
+
+void WriteCounter(FILE* f, const char* name, const char* help, const MetricCounter& c) {
+    fprintf(f, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n",
+            name, help, name, name, (unsigned long long)c.Get());
+}
+
+void WriteHistogramHeader(FILE* f, const char* name, const char* help) {
+    fprintf(f, "# HELP %s %s\n# TYPE %s histogram\n", name, help, name);
+}
+
+/**
+ * @brief Writes one histogram series with cumulative buckets
+ * @param labels Extra labels such as lock="mutex", or empty
+ */
+void WriteHistogram(FILE* f, const char* name, const std::string& labels, const MetricHistogram& h) {
+    std::string sep = labels.empty() ? "" : ",";
+    uint64_t cumulative = 0;
+    for (int i = 0; i < MetricHistogram::BUCKETS; i++) {
+        cumulative += h.counts[i].load(std::memory_order_relaxed);
+        fprintf(f, "%s_bucket{%s%sle=\"%g\"} %llu\n", name, labels.c_str(), sep.c_str(),
+                MetricHistogram::BOUNDS_NS[i] / 1e9, (unsigned long long)cumulative);
+    }
+    cumulative += h.counts[MetricHistogram::BUCKETS].load(std::memory_order_relaxed);
+    fprintf(f, "%s_bucket{%s%sle=\"+Inf\"} %llu\n", name, labels.c_str(), sep.c_str(),
+            (unsigned long long)cumulative);
+
+    std::string braces = labels.empty() ? "" : "{" + labels + "}";
+    fprintf(f, "%s_sum%s %.9f\n", name, braces.c_str(), h.sumNs.load(std::memory_order_relaxed) / 1e9);
+    fprintf(f, "%s_count%s %llu\n", name, braces.c_str(),
+            (unsigned long long)h.count.load(std::memory_order_relaxed));
+}
+
+} // namespace
+
+void MetricHistogram::Record(uint64_t ns) {
+    int b = 0;
+    while (b < BUCKETS && ns > BOUNDS_NS[b]) b++;
+    counts[b].fetch_add(1, std::memory_order_relaxed);
+    sumNs.fetch_add(ns, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t MetricHistogram::Quantile(double q) const {
+    uint64_t total = count.load(std::memory_order_relaxed);
+    if (total == 0) return 0;
+    uint64_t rank = (uint64_t)(q * total), seen = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += counts[b].load(std::memory_order_relaxed);
+        if (seen > rank) return BOUNDS_NS[b];
+    }
+    return UINT64_MAX;
+}
+
+uint64_t MetricsNowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* MetricLockName(MetricLockId id) {
+    return LOCK_NAMES[id];
+}
+
+void LockMutex(pthread_mutex_t* m, MetricLockId id, std::source_location where) {
+    uint64_t start = MetricsNowNs();
+    pthread_mutex_lock(m);
+    NoteLocked(id, MetricsNowNs() - start, where);
+}
+
+void NoteLocked(MetricLockId id, uint64_t waitNs, std::source_location where) {
+    metrics.lockAcquisitions[id].Add();
+    metrics.lockWait[id].Record(waitNs);
+    heldSite[id] = LockProfilingEnabled() ? ProfileLockAcquired(id, waitNs, where) : -1;
+    acquiredAtNs[id] = MetricsNowNs();
+}
+
+void UnlockMutex(pthread_mutex_t* m, MetricLockId id) {
+    uint64_t held = MetricsNowNs() - acquiredAtNs[id];
+    metrics.lockHold[id].Record(held);
+    if (LockProfilingEnabled()) ProfileLockReleased(id, heldSite[id], held);
+    pthread_mutex_unlock(m);
+}
+
+void NoteInputCaptured() {
+    metrics.inputFrame.store(metrics.framesPresented.Get(), std::memory_order_relaxed);
+    metrics.inputAtNs.store(MetricsNowNs(), std::memory_order_release);
+}
+
+void NoteInputHandled() {
+    uint64_t at = metrics.inputAtNs.exchange(0, std::memory_order_acquire);
+    if (at != 0) {
+        uint64_t now = MetricsNowNs();
+        metrics.inputLatency.Record(now - at);
+        // Hand the press over to the render thread, which times it to the screen
+        metrics.handledInputNs.store(at, std::memory_order_relaxed);
+        metrics.handledInputFrame.store(metrics.inputFrame.load(std::memory_order_relaxed),
+                                        std::memory_order_relaxed);
+        metrics.handledAtNs.store(now, std::memory_order_release);
+    }
+}
+
+void NoteFramePresented(uint64_t drawStartNs, uint64_t presentedNs) {
+    metrics.framesPresented.Add();
+    uint64_t handled = metrics.handledAtNs.load(std::memory_order_acquire);
+    if (handled == 0 || handled > drawStartNs) return;
+    if (!metrics.handledAtNs.compare_exchange_strong(handled, 0, std::memory_order_acquire)) return;
+
+    metrics.presentLatency.Record(presentedNs - handled);
+    metrics.clickToPhoton.Record(presentedNs - metrics.handledInputNs.load(std::memory_order_relaxed));
+    uint64_t frames = metrics.framesPresented.Get() - metrics.handledInputFrame.load(std::memory_order_relaxed);
+    metrics.inputFrames[frames < Metrics::MAX_INPUT_FRAMES ? frames : Metrics::MAX_INPUT_FRAMES].Add();
+}
+
+void Metrics::WritePrometheus(FILE* f) const {
+    WriteCounter(f, "multiludo_turns_total", "Turns handed to a player.", turns);
+    WriteCounter(f, "multiludo_moves_total", "Token moves made.", moves);
+    WriteCounter(f, "multiludo_captures_total", "Tokens sent back to their yard.", captures);
+
+    fprintf(f, "# HELP multiludo_lock_acquisitions_total Successful acquisitions of each game mutex.\n"
+               "# TYPE multiludo_lock_acquisitions_total counter\n");
+    for (int i = 0; i < LOCK_COUNT; i++) {
+        fprintf(f, "multiludo_lock_acquisitions_total{lock=\"%s\"} %llu\n",
+                LOCK_NAMES[i], (unsigned long long)lockAcquisitions[i].Get());
+    }
+
+    WriteHistogramHeader(f, "multiludo_lock_wait_seconds", "Time spent waiting to acquire each game mutex.");
+    for (int i = 0; i < LOCK_COUNT; i++) {
+        WriteHistogram(f, "multiludo_lock_wait_seconds", std::string("lock=\"") + LOCK_NAMES[i] + "\"", lockWait[i]);
+    }
+    WriteHistogramHeader(f, "multiludo_lock_hold_seconds", "Time each game mutex was held.");
+    for (int i = 0; i < LOCK_COUNT; i++) {
+        WriteHistogram(f, "multiludo_lock_hold_seconds", std::string("lock=\"") + LOCK_NAMES[i] + "\"", lockHold[i]);
+    }
+
+    WriteHistogramHeader(f, "multiludo_frame_seconds", "Time between presented frames.");
+    WriteHistogram(f, "multiludo_frame_seconds", "", frameTime);
+    WriteHistogramHeader(f, "multiludo_input_latency_seconds", "Mouse press to the roll or move it triggered.");
+    WriteHistogram(f, "multiludo_input_latency_seconds", "", inputLatency);
+    WriteHistogramHeader(f, "multiludo_input_present_seconds", "Roll or move to the end of the first frame showing it.");
+    WriteHistogram(f, "multiludo_input_present_seconds", "", presentLatency);
+    WriteHistogramHeader(f, "multiludo_click_to_photon_seconds", "Mouse press to the end of the first frame showing its result.");
+    WriteHistogram(f, "multiludo_click_to_photon_seconds", "", clickToPhoton);
+
+    // Frame counts are small integers, so their buckets are one frame wide; the sum
+    // counts presses past the last bucket at its lower bound
+    fprintf(f, "# HELP multiludo_click_to_photon_frames Frames presented from a mouse press to the first one showing its result.\n"
+               "# TYPE multiludo_click_to_photon_frames histogram\n");
+    uint64_t cumulative = 0, total = 0;
+    for (int i = 0; i <= MAX_INPUT_FRAMES; i++) {
+        uint64_t n = inputFrames[i].Get();
+        cumulative += n;
+        total += n * i;
+        if (i < MAX_INPUT_FRAMES)
+            fprintf(f, "multiludo_click_to_photon_frames_bucket{le=\"%d\"} %llu\n", i, (unsigned long long)cumulative);
+    }
+    fprintf(f, "multiludo_click_to_photon_frames_bucket{le=\"+Inf\"} %llu\n", (unsigned long long)cumulative);
+    fprintf(f, "multiludo_click_to_photon_frames_sum %llu\n", (unsigned long long)total);
+    fprintf(f, "multiludo_click_to_photon_frames_count %llu\n", (unsigned long long)cumulative);
+}
+
+bool Metrics::Export(const char* path) const {
+    std::string tmp = std::string(path) + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "w");
+    if (f == NULL) return false;
+    WritePrometheus(f);
+    bool ok = fclose(f) == 0;
+    return ok && rename(tmp.c_str(), path) == 0;
+}
@@ -1,78 +1,51 @@
 #include "../include/Player.h"
 #include "../include/Utils.h"
+#include "../include/Bot.h"
+#include "../include/Tablebase.h"
+#include "../include/Metrics.h"
 #include <algorithm>
+#include <bit>
 #include <iostream>
 
 extern pthread_mutex_t mutexDice;
 extern pthread_mutex_t mutexTurn;
 
-Player::Player() : tokens(nullptr), score(0), completed(false), isPlaying(false) {}
+/** @brief Logic ticks a bot waits before each roll or move */
+const int BOT_DELAY_TICKS = 30;
 
+Player::Player() : tokens(nullptr), completed(false), score(0), isPlaying(false), isBot(false) {}
+
+// Tokens live in matchArena and are released with the match
 Player::~Player() {
-    if (tokens != nullptr) {
-        delete[] tokens;
-        tokens = nullptr;
-    }
+    tokens = nullptr;
 }
 
-Player::Player(int i, Color c, Texture2D t) {
-    score = 0;
-    completed = false;
-    id = i;
-    color = c;
-    isPlaying = false;
-    
-    if (numTokens > 0) {
-        tokens = new Token[numTokens];
-        for (int k = 0; k < numTokens; k++) {
-            tokens[k].setTexture(t);
-            tokens[k].setStart(id);
-            tokens[k].gridID = k;
-        }
-
-        int arr[4][4][2] = {
-            {{90, 90}, {200, 90}, {90, 200}, {200, 200}},
-            {{630, 90}, {740, 90}, {630, 200}, {740, 200}},
-            {{630, 630}, {740, 740}, {630, 740}, {740, 630}},
-            {{90, 630}, {200, 630}, {90, 740}, {200, 740}}
-        };
-
-        for (int k = 0; k < numTokens; k++) {
-            tokens[k].initX = arr[id][k][0];
-            tokens[k].initY = arr[id][k][1];
-        }
-    } else {
-        tokens = nullptr;
-    }
+Player::Player(int i, Color c, int sprite) : tokens(nullptr), isBot(false) {
+    setPlayer(i, c, sprite);
 }
 
-void Player::setPlayer(int i, Color c, Texture2D t) {
+void Player::setPlayer(int i, Color c, int sprite, Color tint) {
     completed = false;
     score = 0;
     id = i;
     color = c;
     isPlaying = false;
 
+    tokens = nullptr;
     if (numTokens > 0) {
-        delete[] tokens;  // Clean up any existing tokens
-        tokens = new Token[numTokens];
+        tokens = matchArena.AllocArray<Token>(numTokens);
+        if (tokens == nullptr) {
+            std::cout << "Match arena is full; cannot place tokens" << std::endl;
+            return;
+        }
 
+        const BoardGeometry& board = Board(activeBoard);
         for (int k = 0; k < numTokens; k++) {
-            tokens[k].setTexture(t);
+            tokens[k].setSprite(sprite, tint);
             tokens[k].setStart(id);
             tokens[k].gridID = k;
-        }
-
-        int arr[4][4][2] = {
-            {{90, 90}, {200, 90}, {90, 200}, {200, 200}},
-            {{630, 90}, {740, 90}, {630, 200}, {740, 200}},
-            {{630, 630}, {740, 740}, {630, 740}, {740, 630}},
-            {{90, 630}, {200, 630}, {90, 740}, {200, 740}}
-        };
-
-        for (int k = 0; k < numTokens; k++) {
-            tokens[k].initX = arr[id][k][0];
-            tokens[k].initY = arr[id][k][1];
+            tokens[k].initX = board.yard[id][k].x;
+            tokens[k].initY = board.yard[id][k].y;
         }
     }
 }
@@ -90,10 +63,8 @@ void Player::Start() {
         if (LudoGrid[id][i] == std::make_tuple(-2, -2, -2)) {
             std::cout << "Found this as well" << std::endl;
             tokens[i].inToken();
-            LudoGrid[id][i] = std::make_tuple(-1, -1, -1);
+            tokens[i].updateGrid();
         }
-        tokens[i].drawInit();
-        tokens[i].updateGrid();
         if (tokens[i].finished == false) {
             finCheck = true;
         }
@@ -112,6 +83,12 @@ void Player::Start() {
     }
 }
 
+void Player::draw(TokenBatch& batch) {
+    for (int i = 0; i < numTokens; i++) {
+        tokens[i].draw(batch);
+    }
+}
+
 void Player::allowHome() {
     for (int i = 0; i < numTokens; i++) {
         tokens[i].canGoHome = true;
@@ -123,12 +100,18 @@ void Player::collision(int movedToken) {
         std::cout << "Moved Token: " << movedToken << " is on a Safe Spot" << std::endl;
         return;
     }
-    for (int pid = 0; pid < 4; pid++) {
+    // Only the seats marked on the landing cell can have a token there
+    int cell = TrackCell(id, matchState.pos[id][movedToken], activeBoard);
+    if (cell < 0) return;
+    int others = matchState.cells[cell] & ~(1 << id);
+    for (int pid = 0; others; pid++, others >>= 1) {
+        if (!(others & 1)) continue;
         for (int tokenId = 0; tokenId < numTokens; tokenId++) {
-            if (LudoGrid[pid][tokenId] == tokens[movedToken].gridPos && pid != id) {
+            if (LudoGrid[pid][tokenId] == tokens[movedToken].gridPos) {
                 allowHome();
                 score++;
-                LudoGrid[pid][tokenId] = std::make_tuple(-2, -2, -2);
+                metrics.captures.Add();
+                SetGrid(pid, tokenId, std::make_tuple(-2, -2, -2));
                 std::cout << "found collison" << std::endl;
                 std::cout << "pid: " << pid << std::endl;
                 std::cout << "tokenID: " << tokenId << std::endl;
@@ -141,104 +124,192 @@ void Player::collision(int movedToken) {
 
 void Player::rollDice() {
     if (moveDice == true) {
-        pthread_mutex_lock(&mutexDice);
+        LockMutex(&mutexDice, LOCK_DICE);
         if (id == turn - 1 && movePlayer == false && !completed) {
-            if (completed) {
-                turn = getTurn();
-                pthread_mutex_unlock(&mutexDice);
-                return;
-            }
             Rectangle diceRec = {990, 500, 108.0, 108.0};
-            while(!IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
-                if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                    if (CheckCollisionPointRec(GetMousePosition(), diceRec)) {
-                        dice = (rand() % 6) + 1;
-                        diceCount++;
-                        if (diceCount == 3 && dice == 6) {
-                            pthread_mutex_lock(&mutexTurn);
-                            diceVal.resize(3);
-                            std::fill(diceVal.begin(), diceVal.end(), 0);
-                            turn = getTurn();
-                            diceCount = 0;
-                            lastTurn = turn;
-                            pthread_mutex_unlock(&mutexTurn);
-                            pthread_mutex_unlock(&mutexDice);
-                            return;
-                        }
-                        if (dice == 6) {
-                            diceVal[diceCount - 1] = dice;
+            if (isBot || tickInput.clicked) {
+                if (isBot || CheckCollisionPointRec({(float)tickInput.x, (float)tickInput.y}, diceRec)) {
+                    dice = (rand() % 6) + 1;
+                    diceCount++;
+                    if (!isBot) NoteInputHandled();
+                    if (GameRules::TRIPLE_SIX_FORFEITS && diceCount == RULES_MAX_DICE && dice == 6) {
+                        LockMutex(&mutexTurn, LOCK_TURN);
+                        diceVal.resize(3);
+                        std::fill(diceVal.begin(), diceVal.end(), 0);
+                        turn = getTurn();
+                        diceCount = 0;
+                        lastTurn = turn;
+                        UnlockMutex(&mutexTurn, LOCK_TURN);
+                        UnlockMutex(&mutexDice, LOCK_DICE);
+                        return;
+                    }
+                    if (dice == 6 && diceCount < RULES_MAX_DICE) {
+                        diceVal[diceCount - 1] = dice;
+                        lastTurn = turn;
+                        UnlockMutex(&mutexDice, LOCK_DICE);
+                        return;
+                    }
+                    else {
+                        diceVal[diceCount - 1] = dice;
+                        if (isPlaying == true || diceVal[0] == 6) {
+                            movePlayer = true;
+                            moveDice = false;
                             lastTurn = turn;
-                            pthread_mutex_unlock(&mutexDice);
+                            UnlockMutex(&mutexDice, LOCK_DICE);
                             return;
                         }
                         else {
-                            diceVal[diceCount - 1] = dice;
-                            if (isPlaying == true || diceVal[0] == 6) {
-                                movePlayer = true;
-                                moveDice = false;
-                                lastTurn = turn;
-                                pthread_mutex_unlock(&mutexDice);
-                                return;
-                            }
-                            else {
-                                pthread_mutex_lock(&mutexTurn);
-                                diceVal.resize(3);
-                                std::fill(diceVal.begin(), diceVal.end(), 0);
-                                turn = getTurn();
-                                lastTurn = turn;
-                                pthread_mutex_unlock(&mutexTurn);
-                            }
-                            diceCount = 0;
+                            LockMutex(&mutexTurn, LOCK_TURN);
+                            diceVal.resize(3);
+                            std::fill(diceVal.begin(), diceVal.end(), 0);
+                            turn = getTurn();
+                            lastTurn = turn;
+                            UnlockMutex(&mutexTurn, LOCK_TURN);
                         }
+                        diceCount = 0;
                     }
                 }
             }
         }
-        pthread_mutex_unlock(&mutexDice);
+        UnlockMutex(&mutexDice, LOCK_DICE);
+    }
+}
+
+void Player::fillState(LudoState& s) const {
+    s = matchState;
+    s.turn = (uint8_t)id;
+    s.homeMask = tokens[0].canGoHome ? (uint8_t)(1 << id) : 0;
+}
+
+int Player::legalMoves(LudoMove* out, int capacity) const {
+    if (diceVal.empty()) return 0;
+    LudoState s;
+    fillState(s);
+    int front = diceVal[0];
+    return GenerateMoves<GameRules>(s, id, &front, 1, out, capacity);
+}
+
+void Player::useDie() {
+    diceVal.erase(diceVal.begin());
+    if (diceVal.empty() || diceVal[0] == 0) {
+        LockMutex(&mutexTurn, LOCK_TURN);
+        turn = getTurn();
+        lastTurn = turn;
+        diceVal.resize(3);
+        std::fill(diceVal.begin(), diceVal.end(), 0);
+        movePlayer = false;
+        moveDice = true;
+        diceCount = 0;
+        UnlockMutex(&mutexTurn, LOCK_TURN);
+    }
+}
+
+void Player::recordDie(int token) const {
+    int queued = 0;
+    while (queued < (int)diceVal.size() && diceVal[queued] != 0) queued++;
+    matchRecord.Add(id, diceVal[0], token, queued);
+}
+
+void Player::skipDie() {
+    recordDie(REPLAY_NO_MOVE);
+    useDie();
+}
+
+void Player::moveToken(int i) {
+    metrics.moves.Add();
+    recordDie(i);
+    if (tokens[i].isOut == false) {
+        tokens[i].outToken();
+        isPlaying = true;
+        tokens[i].updateGrid();
     }
+    else {
+        tokens[i].move(diceVal[0]);
+        tokens[i].updateGrid();
+        collision(i);
+    }
+    useDie();
+}
+
+void Player::botMove() {
+    LudoState s;
+    fillState(s);
+    int dice[RULES_MAX_DICE];
+    int count = 0;
+    for (unsigned int k = 0; k < diceVal.size() && diceVal[k] != 0; k++) {
+        dice[count++] = diceVal[k];
+    }
+
+    // The opponent still being queued in this round means we move first
+    int phase = PHASE_SECOND;
+    for (int t : nextTurn) {
+        if (t != id + 1 && std::count(winners.begin(), winners.end(), t) == 0)
+            phase = PHASE_FIRST;
+    }
+
+    LudoMove choice;
+    if (BotChooseMove(s, id, dice, count, phase, choice))
+        moveToken(choice.token);
+    else
+        skipDie();
 }
 
 void Player::move() {
-    bool found = false;
     if (movePlayer == true && lastTurn - 1 == id) {
-        for (int i = 0; i < numTokens; i++) {
-            Rectangle diceRec;
-            if (tokens[i].isOut) {
-                diceRec = {(float)tokens[i].x, (float)tokens[i].y, 60.0, 60.0};
-            }
-            else {
-                diceRec = {(float)tokens[i].initX, (float)tokens[i].initY, 60.0, 60.0};
-            }
-            if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                if (CheckCollisionPointRec(GetMousePosition(), diceRec)) {
-                    found = true;
-                    if (tokens[i].isOut == false && diceVal[0] == 6) {
-                        tokens[i].outToken();
-                        isPlaying = true;
-                        tokens[i].updateGrid();
-                        diceVal.erase(diceVal.begin());
-                    }
-                    else if (tokens[i].isOut == true) {
-                        tokens[i].move(diceVal[0]);
-                        tokens[i].updateGrid();
-                        collision(i);
-                        diceVal.erase(diceVal.begin());
-                        if (diceVal.empty() || diceVal[0] == 0) {
-                            pthread_mutex_lock(&mutexTurn);
-                            turn = getTurn();
-                            lastTurn = turn;
-                            diceVal.resize(3);
-                            std::fill(diceVal.begin(), diceVal.end(), 0);
-                            movePlayer = false;
-                            moveDice = true;
-                            diceCount = 0;
-                            pthread_mutex_unlock(&mutexTurn);
-                        }
-                    }
-                }
+        if (isBot) {
+            botMove();
+            return;
+        }
+
+        LudoMove moves[RULES_MAX_TOKENS];
+        int count = legalMoves(moves, RULES_MAX_TOKENS);
+
+        // No token can use the front die, so skip it instead of waiting for a click
+        if (count == 0) {
+            skipDie();
+            return;
+        }
+        if (!tickInput.clicked)
+            return;
+
+        // Look the click up in the board's hit index instead of testing every token;
+        // spotTokens holds where tokens are, not where their animation has got to
+        int spots[BOARD_HIT_SLOTS];
+        int found = Board(activeBoard).SpotsAt(tickInput.x, tickInput.y, spots);
+        int hit = 0;
+        for (int k = 0; k < found; k++) {
+            hit |= spotTokens[spots[k]][id];
+        }
+        int legal = 0;
+        for (int m = 0; m < count; m++) {
+            legal |= 1 << moves[m].token;
+        }
+
+        // Of stacked tokens, the lowest index with a legal move goes
+        hit &= legal;
+        if (hit != 0) {
+            moveToken(std::countr_zero((unsigned)hit));
+            NoteInputHandled();
+        }
+    }
+}
+
+TurnTask Player::Play(TurnScheduler& scheduler) {
+    while (!completed && !scheduler.StopRequested()) {
+        // Park until the scheduler wakes this seat for its turn
+        if (id != turn - 1) {
+            co_await scheduler.WaitForTurn(id);
+            continue;
+        }
+        // Give humans time to follow what the computer does
+        if (isBot) {
+            for (int i = 0; i < BOT_DELAY_TICKS && !scheduler.StopRequested(); i++) {
+                co_await scheduler.NextTick();
             }
-            if (found)
-                break;
         }
+        // Poll for one dice click or token click, then yield to the next tick
+        rollDice();
+        move();
+        co_await scheduler.NextTick();
     }
-} 
\ No newline at end of file
+}
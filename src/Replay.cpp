@@ -0,0 +1,221 @@
+/**
+ * @file Replay.cpp
+ * @brief Match recording, the replay file, keyframes and seeking
+ */
+
+#include "../include/Replay.h"
+#include <algorithm>
+#include <cstdio>
+
+void PackState(const LudoState& s, uint8_t* out) {
+    for (int p = 0; p < s.numPlayers; p++) {
+        for (int t = 0; t < s.numTokens; t++) *out++ = s.pos[p][t];
+    }
+    *out++ = s.homeMask;
+    *out = s.turn;
+}
+
+void UnpackState(const uint8_t* in, LudoState& s) {
+    for (int p = 0; p < s.numPlayers; p++) {
+        for (int t = 0; t < s.numTokens; t++) s.pos[p][t] = *in++;
+    }
+    s.homeMask = *in++;
+    s.turn = *in;
+    IndexCells(s);
+}
+
+/**
+ * @brief Checks packed position bytes read from a file before anything indexes board tables with them
+ * @param in PackedStateSize bytes
+ * @param s Position whose board, players and tokens are already checked
+ * @return true if every token is at most finished, the turn is a seat and the home mask names seats only
+ */
+static bool ValidPacked(const uint8_t* in, const LudoState& s) {
+    int finished = Board(s.board).finished;
+    for (int i = 0; i < s.numPlayers * s.numTokens; i++) {
+        if (in[i] > finished) return false;
+    }
+    int homeMask = in[s.numPlayers * s.numTokens];
+    int turn = in[s.numPlayers * s.numTokens + 1];
+    return (homeMask >> s.numPlayers) == 0 && turn < s.numPlayers;
+}
+
+/**
+ * @brief Bytes between the read position and the end of a file, or -1
+ */
+static long RemainingBytes(FILE* f) {
+    long here = ftell(f);
+    if (here < 0 || fseek(f, 0, SEEK_END) != 0) return -1;
+    long end = ftell(f);
+    if (fseek(f, here, SEEK_SET) != 0) return -1;
+    return end - here;
+}
+
+void MatchRecord::Start(const LudoState& s) {
+    start = s;
+    events.clear();
+    index.clear();
+    keyframes.clear();
+}
+
+void MatchRecord::Add(int player, int die, int token, int queued) {
+    events.push_back({ (uint8_t)player, (uint8_t)die, (uint8_t)token, (uint8_t)queued });
+}
+
+bool MatchRecord::Save(const char* path) {
+    if (!BuildIndex()) return false;
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) return false;
+    ReplayHeader h = {};
+    h.magic = REPLAY_MAGIC;
+    h.version = REPLAY_VERSION;
+    h.stateSize = sizeof(LudoState);
+    h.events = (uint32_t)events.size();
+    h.keyframeInterval = REPLAY_KEYFRAME_INTERVAL;
+    h.packedSize = (uint16_t)PackedStateSize(start.numPlayers, start.numTokens);
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+              fwrite(&start, sizeof(start), 1, f) == 1 &&
+              fwrite(events.data(), sizeof(ReplayEvent), events.size(), f) == events.size() &&
+              fwrite(index.data(), sizeof(ReplayIndexEntry), index.size(), f) == index.size() &&
+              fwrite(keyframes.data(), 1, keyframes.size(), f) == keyframes.size();
+    return fclose(f) == 0 && ok;
+}
+
+bool MatchRecord::Load(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return false;
+    ReplayHeader h;
+    LudoState s;
+    bool ok = fread(&h, sizeof(h), 1, f) == 1 &&
+              h.magic == REPLAY_MAGIC &&
+              (h.version == 1 || h.version == REPLAY_VERSION) &&
+              h.stateSize == sizeof(LudoState) &&
+              fread(&s, sizeof(s), 1, f) == 1;
+    // Positions on a board this process has not registered cannot be played back
+    ok = ok && s.board < BoardCount() && s.numPlayers == Board(s.board).arms &&
+         s.numTokens >= 1 && s.numTokens <= RULES_MAX_TOKENS;
+    // The starting position is checked like a keyframe, and its cell index rebuilt rather than trusted
+    uint8_t startPacked[RULES_MAX_PLAYERS * RULES_MAX_TOKENS + 2];
+    if (ok) {
+        PackState(s, startPacked);
+        ok = ValidPacked(startPacked, s);
+    }
+    if (ok) IndexCells(s);
+    // Every event must be in the file, so a corrupt count cannot ask for a huge allocation
+    long remaining = ok ? RemainingBytes(f) : -1;
+    ok = ok && remaining >= 0 && (uint64_t)h.events * sizeof(ReplayEvent) <= (uint64_t)remaining;
+    std::vector<ReplayEvent> read;
+    if (ok) {
+        read.resize(h.events);
+        ok = fread(read.data(), sizeof(ReplayEvent), read.size(), f) == read.size();
+    }
+
+    // Keyframes are only trusted at the interval and size this build uses
+    bool indexed = ok && h.version == REPLAY_VERSION && h.keyframeInterval == REPLAY_KEYFRAME_INTERVAL &&
+                   h.packedSize == PackedStateSize(s.numPlayers, s.numTokens);
+    std::vector<ReplayIndexEntry> entries;
+    std::vector<uint8_t> packed;
+    if (indexed) {
+        entries.resize(read.size() / REPLAY_KEYFRAME_INTERVAL + 1);
+        packed.resize(entries.size() * h.packedSize);
+        ok = fread(entries.data(), sizeof(ReplayIndexEntry), entries.size(), f) == entries.size() &&
+             fread(packed.data(), 1, packed.size(), f) == packed.size();
+        for (size_t k = 0; ok && k < entries.size(); k++) {
+            ok = entries[k].event == k * REPLAY_KEYFRAME_INTERVAL && ValidPacked(&packed[k * h.packedSize], s);
+        }
+    }
+    fclose(f);
+    if (!ok) return false;
+    start = s;
+    events.swap(read);
+    index.swap(entries);
+    keyframes.swap(packed);
+    return indexed || BuildIndex();
+}
+
+bool MatchRecord::BuildIndex() {
+    int size = PackedStateSize(start.numPlayers, start.numTokens);
+    index.clear();
+    keyframes.clear();
+    index.reserve(events.size() / REPLAY_KEYFRAME_INTERVAL + 1);
+    keyframes.reserve(index.capacity() * size);
+
+    LudoState s = start;
+    uint32_t turns = 0;
+    for (size_t i = 0; i <= events.size(); i++) {
+        if (i % REPLAY_KEYFRAME_INTERVAL == 0) {
+            index.push_back({ (uint32_t)i, turns });
+            keyframes.resize(keyframes.size() + size);
+            PackState(s, &keyframes[keyframes.size() - size]);
+        }
+        if (i == events.size()) break;
+        if (StartsTurn((int)i)) turns++;
+        if (!ApplyReplayEvent(s, events[i])) {
+            index.clear();
+            keyframes.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MatchRecord::Seek(int event, LudoState& out) const {
+    if (event < 0 || event > (int)events.size()) return false;
+    size_t k = event / REPLAY_KEYFRAME_INTERVAL;
+    if (k >= index.size()) return false;
+
+    out = start;
+    UnpackState(&keyframes[k * PackedStateSize(start.numPlayers, start.numTokens)], out);
+    for (int i = (int)index[k].event; i < event; i++) {
+        if (!ApplyReplayEvent(out, events[i])) return false;
+    }
+    return true;
+}
+
+bool MatchRecord::StartsTurn(int event) const {
+    // A turn starts with a new seat or after the last die of the seat's queue
+    return event == 0 || events[event].player != events[event - 1].player || events[event - 1].queued <= 1;
+}
+
+int MatchRecord::TurnOf(int event) const {
+    size_t k = std::min((size_t)event / REPLAY_KEYFRAME_INTERVAL, index.size() - 1);
+    int from = index.empty() ? 0 : (int)index[k].event;
+    int turns = index.empty() ? 0 : (int)index[k].turn;
+    for (int i = from; i <= event && i < (int)events.size(); i++) {
+        if (StartsTurn(i)) turns++;
+    }
+    return turns;
+}
+
+int MatchRecord::TurnStart(int turn) const {
+    if (turn <= 1) return 0;
+    // The last keyframe before which fewer than turn turns started; turn starts at or after it
+    size_t k = 0;
+    while (k + 1 < index.size() && (int)index[k + 1].turn < turn) k++;
+    int turns = index.empty() ? 0 : (int)index[k].turn;
+    for (int i = index.empty() ? 0 : (int)index[k].event; i < (int)events.size(); i++) {
+        if (StartsTurn(i) && ++turns == turn) return i;
+    }
+    return (int)events.size();
+}
+
+int MatchRecord::TurnCount() const {
+    return events.empty() ? 0 : TurnOf((int)events.size() - 1);
+}
+
+bool ApplyReplayEvent(LudoState& s, const ReplayEvent& e, LudoMove* move) {
+    if (e.player >= s.numPlayers || e.die < 1 || e.die > 6) return false;
+    s.turn = e.player;
+
+    int die = e.die;
+    LudoMove moves[RULES_MAX_TOKENS];
+    int count = GenerateMoves<GameRules>(s, e.player, &die, 1, moves, RULES_MAX_TOKENS);
+    if (e.token == REPLAY_NO_MOVE) return count == 0;
+    for (int i = 0; i < count; i++) {
+        if (moves[i].token != e.token) continue;
+        ApplyMove<GameRules>(s, e.player, moves[i]);
+        if (move != nullptr) *move = moves[i];
+        return true;
+    }
+    return false;
+}
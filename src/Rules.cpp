@@ -0,0 +1,243 @@
+/**
+ * @file Rules.cpp
+ * @brief Headless Ludo rules: move legality, move application and grid mapping
+ *
+ * The board is treated as a ring of track cells taken from its
+ * BoardGeometry. Each arm holds 2 * lane + 1 ring cells: lane along row 0,
+ * the arm tip (row 1, column 0) and lane along row 2. Player i starts on
+ * (i, 2, 1) and enters its home column at (i, 1, 0).
+ */
+
+#include "../include/Rules.h"
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Dimensions of any registered board, read from its geometry
+ */
+struct AnyShape {
+    const BoardGeometry& g;
+    int Lane() const { return g.lane; }
+    int TrackLength() const { return g.trackLength; }
+    int Tip() const { return g.tip; }
+    int HomeFirst() const { return g.homeFirst; }
+    int Finished() const { return g.finished; }
+};
+
+/**
+ * @brief Dimensions of the classic board (always registry id 0) as constants
+ *
+ * Most games are played on it, so its move generation is compiled with the
+ * track bounds folded in.
+ */
+struct ClassicShape {
+    const BoardGeometry& g;
+    static constexpr int Lane() { return POS_FINISHED - TRACK_LENGTH; }
+    static constexpr int TrackLength() { return TRACK_LENGTH; }
+    static constexpr int Tip() { return POS_TIP; }
+    static constexpr int HomeFirst() { return POS_HOME_FIRST; }
+    static constexpr int Finished() { return POS_FINISHED; }
+};
+
+/**
+ * @brief PlaceToken with the board already looked up
+ */
+void MoveToken(const BoardGeometry& g, LudoState& s, int player, int token, int pos) {
+    int from = g.cell[player][s.pos[player][token]];
+    s.pos[player][token] = (uint8_t)pos;
+    if (from >= 0) {
+        bool vacated = true;
+        for (int t = 0; t < s.numTokens; t++) {
+            if (g.cell[player][s.pos[player][t]] == from) vacated = false;
+        }
+        if (vacated) s.cells[from] &= (uint8_t)~(1 << player);
+    }
+    int to = g.cell[player][pos];
+    if (to >= 0) s.cells[to] |= (uint8_t)(1 << player);
+}
+
+/**
+ * @brief Position after reaching a home column index
+ * @param col Index in the home column; lane is the end
+ * @return Relative position, or -1 if the variant needs an exact roll
+ */
+template <class R, class S>
+int HomeColumnTarget(const S& g, int col) {
+    if (col < g.Lane()) return g.TrackLength() + col;
+    return R::EXACT_FINISH && col > g.Lane() ? -1 : g.Finished();
+}
+
+/** @brief MoveTarget for a board shape */
+template <class R, class S>
+int ShapeMoveTarget(const S& g, int pos, int die, bool canGoHome) {
+    if (die < 1 || die > 6) return -1;
+    if (pos == POS_YARD) return die == 6 ? POS_START : -1;
+    if (pos == g.Finished()) return -1;
+
+    if (pos >= g.HomeFirst()) {
+        return HomeColumnTarget<R>(g, pos - g.TrackLength() + die);
+    }
+
+    int target = pos + die;
+    if (canGoHome && pos <= g.Tip() && target > g.Tip()) {
+        return HomeColumnTarget<R>(g, target - g.Tip());
+    }
+    return target > g.TrackLength() ? target - g.TrackLength() : target;
+}
+
+/** @brief GenerateMoves for a board shape */
+template <class R, class S>
+int ShapeGenerateMoves(const S& shape, const LudoState& s, int player, const int* dice, int numDice,
+                       LudoMove* out, int capacity) {
+    const BoardGeometry& g = shape.g;
+    int count = 0;
+    bool canGoHome = !R::CAPTURE_TO_ENTER_HOME || (s.homeMask & (1 << player));
+    int seen = 0;  // Bit per die value already listed
+    int opponents = ~(1 << player);
+
+    for (int d = 0; d < numDice; d++) {
+        int die = dice[d];
+        if (die < 1 || die > 6 || (seen & (1 << die))) continue;
+        seen |= 1 << die;
+
+        for (int t = 0; t < s.numTokens; t++) {
+            int from = s.pos[player][t];
+            int to = ShapeMoveTarget<R>(shape, from, die, canGoHome);
+            if (to < 0) continue;
+            if (count == capacity) return count;
+
+            int flags = 0;
+            if (from == POS_YARD) flags |= MOVE_ENTER;
+            if (to == shape.Finished()) flags |= MOVE_FINISH;
+            int cell = g.cell[player][to];
+            if (cell >= 0) {
+                if (IsSafeCell<R>(g, cell)) flags |= MOVE_SAFE;
+                else if (s.cells[cell] & opponents) flags |= MOVE_CAPTURE;
+            }
+
+            LudoMove& m = out[count++];
+            m.token = (uint8_t)t;
+            m.die = (uint8_t)d;
+            m.from = (uint8_t)from;
+            m.to = (uint8_t)to;
+            m.flags = (uint8_t)flags;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+const TurnDice TURN_DICE[TURN_DICE_COUNT] = {
+    {{1, 0, 0}, 1, 1.0 / 6}, {{2, 0, 0}, 1, 1.0 / 6}, {{3, 0, 0}, 1, 1.0 / 6},
+    {{4, 0, 0}, 1, 1.0 / 6}, {{5, 0, 0}, 1, 1.0 / 6},
+    {{6, 1, 0}, 2, 1.0 / 36}, {{6, 2, 0}, 2, 1.0 / 36}, {{6, 3, 0}, 2, 1.0 / 36},
+    {{6, 4, 0}, 2, 1.0 / 36}, {{6, 5, 0}, 2, 1.0 / 36},
+    {{6, 6, 1}, 3, 1.0 / 216}, {{6, 6, 2}, 3, 1.0 / 216}, {{6, 6, 3}, 3, 1.0 / 216},
+    {{6, 6, 4}, 3, 1.0 / 216}, {{6, 6, 5}, 3, 1.0 / 216},
+    {{6, 6, 6}, 0, 1.0 / 216}
+};
+
+void InitState(LudoState& s, int tokens, int firstTurn, int board) {
+    memset(&s, 0, sizeof(s));
+    s.numTokens = (uint8_t)tokens;
+    s.numPlayers = (uint8_t)Board(board).arms;
+    s.board = (uint8_t)board;
+    s.turn = (uint8_t)firstTurn;
+}
+
+void PlaceToken(LudoState& s, int player, int token, int pos) {
+    MoveToken(Board(s.board), s, player, token, pos);
+}
+
+void IndexCells(LudoState& s) {
+    const BoardGeometry& g = Board(s.board);
+    memset(s.cells, 0, sizeof(s.cells));
+    for (int p = 0; p < s.numPlayers; p++) {
+        for (int t = 0; t < s.numTokens; t++) {
+            int cell = g.cell[p][s.pos[p][t]];
+            if (cell >= 0) s.cells[cell] |= (uint8_t)(1 << p);
+        }
+    }
+}
+
+int TrackCell(int player, int pos, int board) {
+    return Board(board).cell[player][pos];
+}
+
+template <class R>
+int MoveTarget(const BoardGeometry& g, int pos, int die, bool canGoHome) {
+    return ShapeMoveTarget<R>(AnyShape{g}, pos, die, canGoHome);
+}
+
+template <class R>
+int GenerateMoves(const LudoState& s, int player, const int* dice, int numDice, LudoMove* out, int capacity) {
+    const BoardGeometry& g = Board(s.board);
+    if (s.board == BOARD_CLASSIC)
+        return ShapeGenerateMoves<R>(ClassicShape{g}, s, player, dice, numDice, out, capacity);
+    return ShapeGenerateMoves<R>(AnyShape{g}, s, player, dice, numDice, out, capacity);
+}
+
+template <class R>
+int ApplyMove(LudoState& s, int player, const LudoMove& m) {
+    const BoardGeometry& g = Board(s.board);
+    MoveToken(g, s, player, m.token, m.to);
+    if (!(m.flags & MOVE_CAPTURE)) return 0;
+
+    // Only the seats marked on the cell can have tokens there
+    int cell = g.cell[player][m.to];
+    int others = s.cells[cell] & ~(1 << player);
+    s.cells[cell] = (uint8_t)(1 << player);
+    int captured = 0;
+    for (int p = 0; others; p++, others >>= 1) {
+        if (!(others & 1)) continue;
+        for (int t = 0; t < s.numTokens; t++) {
+            if (g.cell[p][s.pos[p][t]] == cell) {
+                s.pos[p][t] = POS_YARD;
+                captured++;
+            }
+        }
+    }
+    s.homeMask |= (uint8_t)(1 << player);
+    return captured;
+}
+
+#define INSTANTIATE_RULES(R) \
+    template int MoveTarget<R>(const BoardGeometry& g, int pos, int die, bool canGoHome); \
+    template int GenerateMoves<R>(const LudoState& s, int player, const int* dice, int numDice, \
+                                  LudoMove* out, int capacity); \
+    template int ApplyMove<R>(LudoState& s, int player, const LudoMove& m);
+RULE_VARIANTS(INSTANTIATE_RULES)
+#undef INSTANTIATE_RULES
+
+int GridToPos(int player, const std::tuple<int, int, int>& grid, int board) {
+    const BoardGeometry& g = Board(board);
+    int arm = std::get<0>(grid);
+    int row = std::get<1>(grid);
+    int col = std::get<2>(grid);
+    if (arm < 0) return POS_YARD;
+
+    // Home column of the owning player
+    if (row == 1 && arm == player && col >= 1) {
+        return col >= g.lane ? g.finished : g.trackLength + col;
+    }
+
+    int inArm = row == 0 ? col : (row == 1 ? g.lane : g.lane + 1 + col);
+    int cell = arm * g.armLength + inArm;
+    int start = player * g.armLength + g.start;
+    return ((cell - start + g.trackLength) % g.trackLength) + 1;
+}
+
+std::tuple<int, int, int> PosToGrid(int player, int pos, int board) {
+    const BoardGeometry& g = Board(board);
+    if (pos == POS_YARD) return std::make_tuple(-1, -1, -1);
+    if (pos >= g.homeFirst) return std::make_tuple(player, 1, pos - g.trackLength);
+
+    int cell = g.cell[player][pos];
+    int arm = cell / g.armLength;
+    int inArm = cell % g.armLength;
+    if (inArm < g.lane) return std::make_tuple(arm, 0, inArm);
+    if (inArm == g.lane) return std::make_tuple(arm, 1, 0);
+    return std::make_tuple(arm, 2, inArm - g.lane - 1);
+}
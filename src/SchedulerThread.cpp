@@ -0,0 +1,185 @@
+/**
+ * @file SchedulerThread.cpp
+ * @brief Fixed-rate thread that drives the turn coroutines, with a bounded stop
+ */
+
+#include "../include/SchedulerThread.h"
+#include "../include/Metrics.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+/**
+ * @brief Absolute CLOCK_REALTIME deadline for timed pthread waits
+ * @param ns Nanoseconds from now
+ * @return Deadline
+ */
+static timespec DeadlineInNs(uint64_t ns) {
+    timespec t;
+    clock_gettime(CLOCK_REALTIME, &t);
+    t.tv_sec += ns / 1000000000ULL;
+    t.tv_nsec += (long)(ns % 1000000000ULL);
+    if (t.tv_nsec >= 1000000000L) {
+        t.tv_sec++;
+        t.tv_nsec -= 1000000000L;
+    }
+    return t;
+}
+
+/**
+ * @brief Absolute CLOCK_REALTIME deadline for timed pthread waits
+ * @param ms Milliseconds from now
+ * @return Deadline
+ */
+static timespec DeadlineIn(int ms) {
+    return DeadlineInNs((uint64_t)ms * 1000000ULL);
+}
+
+/**
+ * @brief Locks a mutex unless a stop is requested while waiting for it
+ * @param m Mutex to lock
+ * @param id Which game mutex it is, for the lock metrics
+ * @param stop Stop token checked every SchedulerThread::STOP_POLL_MS
+ * @param where Call site for the lock profiler
+ * @return true if the mutex is now held
+ */
+static bool LockUnlessStopped(pthread_mutex_t* m, MetricLockId id, const std::stop_token& stop,
+                              std::source_location where = std::source_location::current()) {
+    uint64_t start = MetricsNowNs();
+    while (!stop.stop_requested()) {
+        timespec deadline = DeadlineIn(SchedulerThread::STOP_POLL_MS);
+        if (pthread_mutex_timedlock(m, &deadline) == 0) {
+            NoteLocked(id, MetricsNowNs() - start, where);
+            return true;
+        }
+    }
+    return false;
+}
+
+SchedulerThread::SchedulerThread(TurnScheduler& scheduler, pthread_mutex_t* gameMutex, LogicTick tick, void* context)
+    : tickRate(LOGIC_TICK_RATE), lockstep(false), scheduler(scheduler), gameMutex(gameMutex), tick(tick), context(context),
+      thread(), running(false), pendingInput{false, 0, 0} {
+    pthread_mutex_init(&inputMutex, NULL);
+    pthread_cond_init(&stopCond, NULL);
+}
+
+SchedulerThread::~SchedulerThread() {
+    Join();
+    pthread_cond_destroy(&stopCond);
+    pthread_mutex_destroy(&inputMutex);
+}
+
+bool SchedulerThread::Start() {
+    if (running) return false;
+    stopSource = std::stop_source();
+    scheduler.SetStopToken(stopSource.get_token());
+    if (lockstep) {
+        running = true;
+        return true;
+    }
+    running = pthread_create(&thread, NULL, &SchedulerThread::ThreadMain, this) == 0;
+    return running;
+}
+
+void SchedulerThread::RequestStop() {
+    stopSource.request_stop();
+    pthread_mutex_lock(&inputMutex);
+    pthread_cond_broadcast(&stopCond);
+    pthread_mutex_unlock(&inputMutex);
+}
+
+bool SchedulerThread::Stop(double* elapsedMs) {
+    if (!running) return true;
+    auto start = std::chrono::steady_clock::now();
+    RequestStop();
+    if (lockstep) {
+        Finish();
+        running = false;
+    } else {
+        timespec deadline = DeadlineIn(SHUTDOWN_DEADLINE_MS);
+        running = pthread_timedjoin_np(thread, NULL, &deadline) != 0;
+    }
+    if (elapsedMs != nullptr) {
+        *elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    return !running;
+}
+
+void SchedulerThread::Join() {
+    if (!running) return;
+    RequestStop();
+    if (lockstep) Finish();
+    else pthread_join(thread, NULL);
+    running = false;
+}
+
+void SchedulerThread::Step() {
+    if (!running || stopSource.stop_requested()) return;
+    LockMutex(gameMutex, LOCK_GAME);
+    tick(context, Take());
+    UnlockMutex(gameMutex, LOCK_GAME);
+}
+
+void SchedulerThread::Latch(int x, int y) {
+    pthread_mutex_lock(&inputMutex);
+    pendingInput = {true, x, y};
+    pthread_mutex_unlock(&inputMutex);
+}
+
+TickInput SchedulerThread::Take() {
+    pthread_mutex_lock(&inputMutex);
+    TickInput in = pendingInput;
+    pendingInput.clicked = false;
+    pthread_mutex_unlock(&inputMutex);
+    return in;
+}
+
+void* SchedulerThread::ThreadMain(void* args) {
+    ((SchedulerThread*)args)->Loop();
+    return NULL;
+}
+
+/**
+ * @brief Ticks until a stop is requested, then lets every coroutine see it
+ */
+void SchedulerThread::Loop() {
+    std::stop_token stop = stopSource.get_token();
+    uint64_t step = 1000000000ULL / (tickRate > 0 ? tickRate : LOGIC_TICK_RATE);
+    uint64_t nextTick = MetricsNowNs();
+    while (!stop.stop_requested()) {
+        // Sleep until the next tick is due
+        uint64_t now = MetricsNowNs();
+        if (now < nextTick) {
+            uint64_t wait = std::min<uint64_t>(nextTick - now, (uint64_t)STOP_POLL_MS * 1000000ULL);
+            timespec deadline = DeadlineInNs(wait);
+            pthread_mutex_lock(&inputMutex);
+            if (!stop.stop_requested())
+                pthread_cond_timedwait(&stopCond, &inputMutex, &deadline);
+            pthread_mutex_unlock(&inputMutex);
+            continue;
+        }
+        if (now - nextTick > MAX_CATCHUP_TICKS * step)
+            nextTick = now - MAX_CATCHUP_TICKS * step;
+        nextTick += step;
+
+        if (!LockUnlessStopped(gameMutex, LOCK_GAME, stop))
+            break;
+        tick(context, Take());
+        UnlockMutex(gameMutex, LOCK_GAME);
+    }
+    Finish();
+}
+
+/**
+ * @brief Resumes every coroutine once more; each sees the stop request and returns
+ */
+void SchedulerThread::Finish() {
+    uint64_t start = MetricsNowNs();
+    timespec deadline = DeadlineIn(STOP_POLL_MS);
+    if (pthread_mutex_timedlock(gameMutex, &deadline) == 0) {
+        NoteLocked(LOCK_GAME, MetricsNowNs() - start);
+        scheduler.WakeAll();
+        scheduler.Tick();
+        UnlockMutex(gameMutex, LOCK_GAME);
+    }
+}
@@ -0,0 +1,218 @@
+/**
+ * @file Simulator.cpp
+ * @brief Headless full-game simulation on the rules engine
+ */
+
+#include "../include/Simulator.h"
+#include "../include/Bot.h"
+#include "../include/Evaluator.h"
+#include "../include/Tablebase.h"
+#include <algorithm>
+#include <cmath>
+
+/** @brief Power the work ratio is raised to in SimLengthScale */
+static const double SIM_LENGTH_EXPONENT = 1.3;
+
+double SimLengthScale(int board, int tokens) {
+    const BoardGeometry& g = Board(board);
+    const BoardGeometry& classic = Board(BOARD_CLASSIC);
+    double work = (double)g.arms * g.arms * g.finished * tokens;
+    double classicWork = (double)classic.arms * classic.arms * classic.finished * CLASSIC_TOKENS;
+    return std::max(1.0, std::pow(work / classicWork, SIM_LENGTH_EXPONENT));
+}
+
+int SimMaxTurns(int board, int tokens) {
+    return (int)std::ceil(SIM_MAX_TURNS * SimLengthScale(board, tokens));
+}
+
+int SimLengthBucket(int board, int tokens) {
+    return (int)std::ceil(SIM_LENGTH_BUCKET * SimLengthScale(board, tokens));
+}
+
+void SimTurnOrder::Deal(SimRng& rng) {
+    for (int i = 0; i < players; i++) order[i] = i;
+    for (int i = players - 1; i > 0; i--) {
+        int j = rng.Below(i + 1);
+        int t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+    left = players;
+}
+
+int SimTurnOrder::Next(SimRng& rng, const bool* done) {
+    while (true) {
+        if (left == 0) Deal(rng);
+        int seat = order[--left];
+        if (!done[seat]) return seat;
+    }
+}
+
+bool SimTurnOrder::Pending(int seat) const {
+    for (int i = 0; i < left; i++) {
+        if (order[i] == seat) return true;
+    }
+    return false;
+}
+
+bool SimAllFinished(const LudoState& s, int player) {
+    int finished = Board(s.board).finished;
+    for (int t = 0; t < s.numTokens; t++) {
+        if (s.pos[player][t] != finished) return false;
+    }
+    return true;
+}
+
+float SimPositionValue(const Evaluator& e, const LudoState& s, int player) {
+    if (SimAllFinished(s, player)) return 1.0f;
+    float x[EVAL_FEATURES];
+    EvalFeatures(s, player, x);
+    return e.Value(x);
+}
+
+void SimGreedyTurn(LudoState& s, int player, const int* dice, int numDice) {
+    for (int k = 0; k < numDice; k++) {
+        LudoMove moves[RULES_MAX_TOKENS];
+        int count = GenerateMoves<GameRules>(s, player, dice + k, 1, moves, RULES_MAX_TOKENS);
+        if (count == 0) continue;
+        int best = 0;
+        for (int i = 1; i < count; i++) {
+            if (GreedyScore(moves[i]) > GreedyScore(moves[best])) best = i;
+        }
+        ApplyMove<GameRules>(s, player, moves[best]);
+    }
+}
+
+bool SimBotPolicy(const LudoState& s, int player, const int* dice, int numDice,
+                  int phase, SimRng& rng, LudoMove& out) {
+    (void)rng;
+    return BotChooseMove(s, player, dice, numDice, phase, out);
+}
+
+template <class R>
+bool SimGreedyPolicy(const LudoState& s, int player, const int* dice, int numDice,
+                     int phase, SimRng& rng, LudoMove& out) {
+    (void)numDice;
+    (void)phase;
+    (void)rng;
+    LudoMove moves[RULES_MAX_TOKENS];
+    int count = GenerateMoves<R>(s, player, dice, 1, moves, RULES_MAX_TOKENS);
+    if (count == 0) return false;
+    int best = 0;
+    for (int i = 1; i < count; i++) {
+        if (GreedyScore(moves[i]) > GreedyScore(moves[best])) best = i;
+    }
+    out = moves[best];
+    return true;
+}
+
+template <class R>
+bool SimRandomPolicy(const LudoState& s, int player, const int* dice, int numDice,
+                     int phase, SimRng& rng, LudoMove& out) {
+    (void)numDice;
+    (void)phase;
+    LudoMove moves[RULES_MAX_TOKENS];
+    int count = GenerateMoves<R>(s, player, dice, 1, moves, RULES_MAX_TOKENS);
+    if (count == 0) return false;
+    out = moves[rng.Below(count)];
+    return true;
+}
+
+template <class R>
+SimResult SimulateGame(int tokens, const SimPolicy* policies, SimRng& rng, SimStats* stats, int board,
+                       SimRng* policyRngs) {
+    SimResult result = {};
+    LudoState s;
+    InitState(s, tokens, 0, board);
+    const BoardGeometry& g = Board(board);
+    int seats = g.arms;
+
+    bool done[RULES_MAX_PLAYERS] = {};
+    int placed = 0;
+    SimTurnOrder order(seats);
+    int maxTurns = SimMaxTurns(board, tokens);
+
+    while (placed < seats - 1 && result.turns < maxTurns) {
+        int player = order.Next(rng, done);
+        s.turn = (uint8_t)player;
+        result.turns++;
+
+        // Roll the turn's dice: a six rolls again, the third six forfeits or ends the turn
+        int dice[RULES_MAX_DICE];
+        int numDice = 0;
+        bool tripleSix = false;
+        while (true) {
+            int d = rng.Die();
+            if (d == 6 && numDice == RULES_MAX_DICE - 1) {
+                tripleSix = true;
+                if (!R::TRIPLE_SIX_FORFEITS) dice[numDice++] = d;
+                break;
+            }
+            dice[numDice++] = d;
+            if (d != 6) break;
+        }
+        if (tripleSix && stats) stats->tripleSixes.Add();
+        if (tripleSix && R::TRIPLE_SIX_FORFEITS) continue;
+
+        // With two seats left the bot needs to know who moves next
+        int phase = PHASE_SECOND;
+        for (int p = 0; placed == seats - 2 && p < seats; p++) {
+            if (p != player && !done[p] && order.Pending(p)) phase = PHASE_FIRST;
+        }
+
+        SimRng& decide = policyRngs != nullptr ? policyRngs[player] : rng;
+        for (int k = 0; k < numDice; k++) {
+            LudoMove m;
+            if (!policies[player](s, player, dice + k, numDice - k, phase, decide, m)) continue;
+            int captured = ApplyMove<R>(s, player, m);
+            if (stats) {
+                stats->moves.Add();
+                if (captured > 0) {
+                    stats->captures.Add(captured);
+                    stats->capturesBySquare[g.cell[player][m.to]].Add(captured);
+                }
+            }
+            if (SimAllFinished(s, player)) {
+                done[player] = true;
+                result.places[placed++] = player;
+                break;
+            }
+        }
+    }
+
+    result.finished = placed == seats - 1;
+    if (result.finished) {
+        for (int p = 0; p < seats; p++) {
+            if (!done[p]) result.places[placed] = p;
+        }
+    }
+
+    if (stats) {
+        stats->players = seats;
+        stats->trackCells = g.trackLength;
+        stats->turns.Add(result.turns);
+        if (!result.finished) {
+            stats->unfinished.Add();
+            return result;
+        }
+        stats->games.Add();
+        stats->finishedTurns.Add(result.turns);
+        stats->seatWins[result.places[0]].Add();
+        for (int place = 0; place < seats; place++) {
+            stats->seatPlaces[result.places[place]][place].Add();
+        }
+        stats->gameLength.Add(result.turns);
+        stats->gameLengthSketch.Add(result.turns);
+    }
+    return result;
+}
+
+#define INSTANTIATE_SIM(R) \
+    template bool SimGreedyPolicy<R>(const LudoState& s, int player, const int* dice, int numDice, \
+                                     int phase, SimRng& rng, LudoMove& out); \
+    template bool SimRandomPolicy<R>(const LudoState& s, int player, const int* dice, int numDice, \
+                                     int phase, SimRng& rng, LudoMove& out); \
+    template SimResult SimulateGame<R>(int tokens, const SimPolicy* policies, SimRng& rng, SimStats* stats, \
+                                       int board, SimRng* policyRngs);
+RULE_VARIANTS(INSTANTIATE_SIM)
+#undef INSTANTIATE_SIM
@@ -0,0 +1,340 @@
+/**
+ * @file Snapshot.cpp
+ * @brief Versioned binary save/restore of an in-progress match
+ *
+ * Layout (all integers little-endian):
+ * - Header: magic u32, version u16, numTokens u8, screen u8, payload size u32, checksum u32
+ * - Globals: board id, seats, turn, lastTurn, dice, diceCount, flags, finished-thread mask,
+ *   then counted arrays for diceVal (3), nextTurn (8) and winners (8)
+ * - Per player: score i32, flags u8 (completed, playing, bot), then per token gridPos (3 x i8), x/y (i16), flags u8
+ *   and the matching LudoGrid entry (3 x i8)
+ */
+
+#include "../include/Snapshot.h"
+#include "../include/Game.h"
+#include "../include/Utils.h"
+#include "../include/Metrics.h"
+#include "../include/BoardGeometry.h"
+#include <cstdio>
+#include <vector>
+
+extern pthread_mutex_t mutex;
+
+namespace {
+
+const size_t GLOBALS_SIZE = 30;   // Fixed bytes for board/turn/dice/order state
+const size_t PLAYER_SIZE = 5;     // Score plus player flags
+const size_t TOKEN_SIZE = 11;     // Token state plus its LudoGrid entry
+const int MAX_DICE = 3;
+const int MAX_ORDER = BOARD_MAX_ARMS;
+
+/**
+ * @brief Minimal cursor for writing fixed-width little-endian values
+ */
+struct Writer {
+    uint8_t* p;
+    void u8(int v) { *p++ = (uint8_t)v; }
+    void u16(int v) { u8(v & 0xFF); u8((v >> 8) & 0xFF); }
+    void u32(uint32_t v) { u16(v & 0xFFFF); u16(v >> 16); }
+};
+
+/**
+ * @brief Minimal cursor for reading fixed-width little-endian values
+ */
+struct Reader {
+    const uint8_t* p;
+    int u8() { return *p++; }
+    int s8() { return (int8_t)*p++; }
+    int u16() { int lo = u8(); int hi = u8(); return lo | (hi << 8); }
+    int s16() { return (int16_t)u16(); }
+    uint32_t u32() { uint32_t lo = u16(); uint32_t hi = u16(); return lo | (hi << 16); }
+};
+
+/**
+ * @brief FNV-1a hash used to detect truncated or corrupted snapshots
+ */
+uint32_t Checksum(const uint8_t* data, size_t size) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        h ^= data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief Writes a counted array of small values with a fixed number of slots
+ */
+void WriteList(Writer& w, const std::vector<int>& v, int slots) {
+    int n = (int)v.size() < slots ? (int)v.size() : slots;
+    w.u8(n);
+    for (int i = 0; i < slots; i++) {
+        w.u8(i < n ? v[i] : 0);
+    }
+}
+
+/**
+ * @brief Reads a counted array written by WriteList
+ */
+bool ReadList(Reader& r, std::vector<int>& v, int slots, int lo, int hi) {
+    int n = r.u8();
+    if (n > slots) return false;
+    v.resize(n);
+    bool ok = true;
+    for (int i = 0; i < slots; i++) {
+        int val = r.u8();
+        if (i < n) {
+            v[i] = val;
+            ok = ok && val >= lo && val <= hi;
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Reads a grid tuple and checks it names a square the player's token can stand on
+ */
+bool ReadGrid(Reader& r, int board, int player, std::tuple<int, int, int>& g) {
+    int arm = r.s8();
+    int row = r.s8();
+    int col = r.s8();
+    g = std::make_tuple(arm, row, col);
+    if (arm < 0) return arm == -1 && row == -1 && col == -1;
+    const BoardGeometry& geometry = Board(board);
+    if (arm >= geometry.arms || row < 0 || row > 2 || col < 0 || col > geometry.lane) return false;
+    // Only tuples the rules engine would produce for that player round-trip
+    return PosToGrid(player, GridToPos(player, g, board), board) == g;
+}
+
+/**
+ * @brief One token as stored in a snapshot
+ */
+struct TokenRecord {
+    std::tuple<int, int, int> gridPos;
+    int x, y;
+    int flags;
+    std::tuple<int, int, int> grid;     ///< Matching LudoGrid entry
+};
+
+/**
+ * @brief One player as stored in a snapshot
+ */
+struct PlayerRecord {
+    int score;
+    int flags;
+    TokenRecord tokens[RULES_MAX_TOKENS];
+};
+
+/**
+ * @brief Whole payload of a snapshot, decoded and checked before any of it is applied
+ */
+struct SnapshotData {
+    int turn, lastTurn, dice, diceCount, flags, finishedMask;
+    std::vector<int> diceVal, nextTurn, winners;
+    PlayerRecord players[BOARD_MAX_ARMS];
+};
+
+/**
+ * @brief Decodes the payload after the board id and seat count
+ * @return false if any field is out of range for the board and token count
+ */
+bool Decode(Reader& r, int board, int seats, int tokens, SnapshotData& d) {
+    d.turn = r.u8();
+    d.lastTurn = r.u8();
+    d.dice = r.u8();
+    d.diceCount = r.u8();
+    d.flags = r.u8();
+    d.finishedMask = r.u8();
+    bool ok = d.turn >= 1 && d.turn <= seats &&
+              d.lastTurn >= 1 && d.lastTurn <= seats &&
+              d.dice >= 1 && d.dice <= 6 &&
+              d.diceCount <= MAX_DICE &&
+              (d.finishedMask >> seats) == 0;
+    ok = ReadList(r, d.diceVal, MAX_DICE, 0, 6) && ok;
+    ok = ReadList(r, d.nextTurn, MAX_ORDER, 1, seats) && ok;
+    ok = ReadList(r, d.winners, MAX_ORDER, 1, seats) && ok;
+
+    for (int i = 0; ok && i < seats; i++) {
+        PlayerRecord& p = d.players[i];
+        p.score = (int)r.u32();
+        p.flags = r.u8();
+        for (int k = 0; ok && k < tokens; k++) {
+            TokenRecord& t = p.tokens[k];
+            ok = ReadGrid(r, board, i, t.gridPos);
+            t.x = r.s16();
+            t.y = r.s16();
+            t.flags = r.u8();
+            ok = ReadGrid(r, board, i, t.grid) && ok;
+        }
+    }
+    return ok;
+}
+
+} // namespace
+
+size_t SnapshotSize(int players, int tokens) {
+    return SNAPSHOT_HEADER_SIZE + GLOBALS_SIZE + players * (PLAYER_SIZE + TOKEN_SIZE * tokens);
+}
+
+size_t WriteSnapshot(const Game& game, uint8_t* buffer, size_t capacity) {
+    if (numTokens < 1 || numTokens > RULES_MAX_TOKENS || LudoGrid == nullptr) return 0;
+    int seats = Board(activeBoard).arms;
+    size_t total = SnapshotSize(seats, numTokens);
+    if (capacity < total) return 0;
+
+    Writer w{buffer + SNAPSHOT_HEADER_SIZE};
+
+    // Board first, so a reader knows the layout before the rest
+    w.u8(activeBoard);
+    w.u8(seats);
+
+    // Global turn and dice state
+    w.u8(turn);
+    w.u8(lastTurn);
+    w.u8(dice);
+    w.u8(diceCount);
+    w.u8((movePlayer ? 1 : 0) | (moveDice ? 2 : 0) | (game.WinnerScreen ? 4 : 0));
+    int finishedMask = 0;
+    for (int i = 0; i < seats; i++) {
+        if (game.FinishedThreads[i]) finishedMask |= 1 << i;
+    }
+    w.u8(finishedMask);
+    WriteList(w, diceVal, MAX_DICE);
+    WriteList(w, nextTurn, MAX_ORDER);
+    WriteList(w, winners, MAX_ORDER);
+
+    // Players and their tokens
+    for (int i = 0; i < seats; i++) {
+        const Player* p = &game.players[i];
+        w.u32((uint32_t)p->score);
+        w.u8((p->completed ? 1 : 0) | (p->isPlaying ? 2 : 0) | (p->isBot ? 4 : 0));
+        for (int k = 0; k < numTokens; k++) {
+            const Token& t = p->tokens[k];
+            w.u8(std::get<0>(t.gridPos));
+            w.u8(std::get<1>(t.gridPos));
+            w.u8(std::get<2>(t.gridPos));
+            w.u16(t.x);
+            w.u16(t.y);
+            w.u8((t.isSafe ? 1 : 0) | (t.canGoHome ? 2 : 0) | (t.finished ? 4 : 0) | (t.isOut ? 8 : 0));
+            w.u8(std::get<0>(LudoGrid[i][k]));
+            w.u8(std::get<1>(LudoGrid[i][k]));
+            w.u8(std::get<2>(LudoGrid[i][k]));
+        }
+    }
+
+    // Header last so the checksum covers the finished payload
+    uint32_t payloadSize = (uint32_t)(total - SNAPSHOT_HEADER_SIZE);
+    Writer h{buffer};
+    h.u32(SNAPSHOT_MAGIC);
+    h.u16(SNAPSHOT_VERSION);
+    h.u8(numTokens);
+    h.u8(game.screen);
+    h.u32(payloadSize);
+    h.u32(Checksum(buffer + SNAPSHOT_HEADER_SIZE, payloadSize));
+    return total;
+}
+
+bool ReadSnapshot(Game& game, const uint8_t* buffer, size_t size) {
+    if (size < SNAPSHOT_HEADER_SIZE) return false;
+
+    Reader h{buffer};
+    if (h.u32() != SNAPSHOT_MAGIC) return false;
+    if (h.u16() != SNAPSHOT_VERSION) return false;
+
+    int tokens = h.u8();
+    int screen = h.u8();
+    uint32_t payloadSize = h.u32();
+    uint32_t checksum = h.u32();
+    if (tokens < 1 || tokens > RULES_MAX_TOKENS || screen < 1 || screen > 3 || payloadSize < 2) return false;
+    if (size < SNAPSHOT_HEADER_SIZE + payloadSize) return false;
+    if (Checksum(buffer + SNAPSHOT_HEADER_SIZE, payloadSize) != checksum) return false;
+
+    // Boards loaded from files are only valid if registered in the same order again
+    Reader r{buffer + SNAPSHOT_HEADER_SIZE};
+    int board = r.u8();
+    int seats = r.u8();
+    if (board >= BoardCount() || Board(board).arms != seats) return false;
+    if (payloadSize != SnapshotSize(seats, tokens) - SNAPSHOT_HEADER_SIZE) return false;
+
+    SnapshotData d;
+    if (!Decode(r, board, seats, tokens, d)) return false;
+
+    // Hold the game mutex so the scheduler cannot act on a half-restored match
+    LockMutex(&mutex, LOCK_GAME);
+
+    numTokens = tokens;
+    game.selectedBoard = board;
+    game.StartMatch();
+    game.screen = screen;
+
+    turn = d.turn;
+    lastTurn = d.lastTurn;
+    dice = d.dice;
+    diceCount = d.diceCount;
+    movePlayer = d.flags & 1;
+    moveDice = d.flags & 2;
+    game.WinnerScreen = d.flags & 4;
+    for (int i = 0; i < seats; i++) {
+        game.FinishedThreads[i] = d.finishedMask & (1 << i);
+    }
+    diceVal = d.diceVal;
+    nextTurn = d.nextTurn;
+    winners = d.winners;
+
+    for (int i = 0; i < seats; i++) {
+        Player* p = &game.players[i];
+        p->score = d.players[i].score;
+        p->completed = d.players[i].flags & 1;
+        p->isPlaying = d.players[i].flags & 2;
+        p->isBot = d.players[i].flags & 4;
+        for (int k = 0; k < numTokens; k++) {
+            const TokenRecord& stored = d.players[i].tokens[k];
+            Token& t = p->tokens[k];
+            t.gridPos = stored.gridPos;
+            t.x = stored.x;
+            t.y = stored.y;
+            t.isSafe = stored.flags & 1;
+            t.canGoHome = stored.flags & 2;
+            t.finished = stored.flags & 4;
+            t.isOut = stored.flags & 8;
+            if (t.isOut) {
+                sem_post(&t.semToken);  // Balance the wait in inToken()
+            }
+            SetGrid(i, k, stored.grid);
+        }
+    }
+
+    // The replay of a resumed match starts from the restored position
+    LudoState start = matchState;
+    start.homeMask = 0;
+    for (int i = 0; i < seats; i++) {
+        if (game.players[i].tokens[0].canGoHome) start.homeMask |= (uint8_t)(1 << i);
+    }
+    matchRecord.Start(start);
+
+    UnlockMutex(&mutex, LOCK_GAME);
+    return true;
+}
+bool SaveSnapshot(const Game& game, const char* path) {
+    // Sized for the largest match, so nothing is allocated under the lock
+    std::vector<uint8_t> buffer(SnapshotSize(BOARD_MAX_ARMS, RULES_MAX_TOKENS));
+    LockMutex(&mutex, LOCK_GAME);
+    size_t n = numTokens >= 1 && numTokens <= RULES_MAX_TOKENS ? WriteSnapshot(game, buffer.data(), buffer.size()) : 0;
+    UnlockMutex(&mutex, LOCK_GAME);
+    if (n == 0) return false;
+
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) return false;
+    bool ok = fwrite(buffer.data(), 1, n, f) == n;
+    fclose(f);
+    return ok;
+}
+
+bool LoadSnapshot(Game& game, const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return false;
+    std::vector<uint8_t> buffer(SnapshotSize(BOARD_MAX_ARMS, RULES_MAX_TOKENS));
+    size_t n = fread(buffer.data(), 1, buffer.size(), f);
+    fclose(f);
+    return ReadSnapshot(game, buffer.data(), n);
+}
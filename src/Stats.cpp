@@ -0,0 +1,153 @@
+/**
+ * @file Stats.cpp
+ * @brief Streaming aggregators for simulation runs
+ */
+
+#include "../include/Stats.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const double SKETCH_GAMMA = 1.02;   // Bucket growth factor, about 1% relative error
+const double SKETCH_LOG_GAMMA = std::log(SKETCH_GAMMA);
+
+} // namespace
+
+FixedHistogram::FixedHistogram(int bucketWidth) : width(bucketWidth), overflow(0) {
+    memset(counts, 0, sizeof(counts));
+}
+
+void FixedHistogram::Add(int v) {
+    int b = v / width;
+    if (b < 0) b = 0;
+    if (b >= BUCKETS) overflow++;
+    else counts[b]++;
+}
+
+void FixedHistogram::Merge(const FixedHistogram& other) {
+    for (int i = 0; i < BUCKETS; i++) counts[i] += other.counts[i];
+    overflow += other.overflow;
+}
+
+QuantileSketch::QuantileSketch() : count(0) {
+    memset(counts, 0, sizeof(counts));
+}
+
+void QuantileSketch::Add(double v) {
+    int b = v <= 1.0 ? 0 : (int)std::ceil(std::log(v) / SKETCH_LOG_GAMMA);
+    if (b >= BUCKETS) b = BUCKETS - 1;
+    counts[b]++;
+    count++;
+}
+
+void QuantileSketch::Merge(const QuantileSketch& other) {
+    for (int i = 0; i < BUCKETS; i++) counts[i] += other.counts[i];
+    count += other.count;
+}
+
+double QuantileSketch::Quantile(double q) const {
+    if (count == 0) return 0.0;
+    uint64_t rank = (uint64_t)(q * (count - 1));
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += counts[i];
+        if (seen > rank) {
+            // Midpoint of the bucket (gamma^(i-1), gamma^i]
+            return i == 0 ? 1.0 : 2.0 * std::pow(SKETCH_GAMMA, i) / (1.0 + SKETCH_GAMMA);
+        }
+    }
+    return std::pow(SKETCH_GAMMA, BUCKETS - 1);
+}
+
+SimStats::SimStats(int lengthBucket) : players(CLASSIC_PLAYERS), trackCells(TRACK_LENGTH), gameLength(lengthBucket) {}
+
+void SimStats::Merge(const SimStats& other) {
+    games.Merge(other.games);
+    unfinished.Merge(other.unfinished);
+    turns.Merge(other.turns);
+    finishedTurns.Merge(other.finishedTurns);
+    moves.Merge(other.moves);
+    captures.Merge(other.captures);
+    tripleSixes.Merge(other.tripleSixes);
+    if (other.players > players) players = other.players;
+    if (other.trackCells > trackCells) trackCells = other.trackCells;
+    for (int p = 0; p < RULES_MAX_PLAYERS; p++) {
+        seatWins[p].Merge(other.seatWins[p]);
+        for (int place = 0; place < RULES_MAX_PLAYERS; place++) {
+            seatPlaces[p][place].Merge(other.seatPlaces[p][place]);
+        }
+    }
+    for (int c = 0; c < BOARD_MAX_TRACK; c++) {
+        capturesBySquare[c].Merge(other.capturesBySquare[c]);
+    }
+    gameLength.Merge(other.gameLength);
+    gameLengthSketch.Merge(other.gameLengthSketch);
+}
+
+void SimStats::WriteJson(FILE* f) const {
+    double n = games.value > 0 ? (double)games.value : 1.0;
+    fprintf(f, "{\n");
+    fprintf(f, "  \"games\": %llu,\n", (unsigned long long)games.value);
+    fprintf(f, "  \"unfinished\": %llu,\n", (unsigned long long)unfinished.value);
+    fprintf(f, "  \"turns\": %llu,\n", (unsigned long long)turns.value);
+    fprintf(f, "  \"moves\": %llu,\n", (unsigned long long)moves.value);
+    fprintf(f, "  \"captures\": %llu,\n", (unsigned long long)captures.value);
+    fprintf(f, "  \"triple_sixes\": %llu,\n", (unsigned long long)tripleSixes.value);
+    fprintf(f, "  \"triple_six_rate_per_turn\": %.6f,\n",
+            turns.value > 0 ? (double)tripleSixes.value / turns.value : 0.0);
+
+    fprintf(f, "  \"seat_win_rate\": [");
+    for (int p = 0; p < players; p++) {
+        fprintf(f, "%s%.6f", p ? ", " : "", seatWins[p].value / n);
+    }
+    fprintf(f, "],\n  \"seat_places\": [");
+    for (int p = 0; p < players; p++) {
+        fprintf(f, "%s[", p ? ", " : "");
+        for (int place = 0; place < players; place++) {
+            fprintf(f, "%s%llu", place ? ", " : "", (unsigned long long)seatPlaces[p][place].value);
+        }
+        fprintf(f, "]");
+    }
+
+    fprintf(f, "],\n  \"game_length\": {\"mean\": %.2f, \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, ",
+            finishedTurns.value / n, gameLengthSketch.Quantile(0.5), gameLengthSketch.Quantile(0.9),
+            gameLengthSketch.Quantile(0.99));
+    fprintf(f, "\"bucket_width\": %d, \"buckets\": [", gameLength.width);
+    for (int i = 0; i < FixedHistogram::BUCKETS; i++) {
+        fprintf(f, "%s%llu", i ? ", " : "", (unsigned long long)gameLength.counts[i]);
+    }
+    fprintf(f, "], \"overflow\": %llu},\n", (unsigned long long)gameLength.overflow);
+
+    fprintf(f, "  \"captures_by_square\": [");
+    for (int c = 0; c < trackCells; c++) {
+        fprintf(f, "%s%llu", c ? ", " : "", (unsigned long long)capturesBySquare[c].value);
+    }
+    fprintf(f, "]\n}\n");
+}
+
+void SimStats::WriteCsv(FILE* f) const {
+    fprintf(f, "metric,key,value\n");
+    fprintf(f, "games,,%llu\n", (unsigned long long)games.value);
+    fprintf(f, "unfinished,,%llu\n", (unsigned long long)unfinished.value);
+    fprintf(f, "turns,,%llu\n", (unsigned long long)turns.value);
+    fprintf(f, "moves,,%llu\n", (unsigned long long)moves.value);
+    fprintf(f, "captures,,%llu\n", (unsigned long long)captures.value);
+    fprintf(f, "triple_sixes,,%llu\n", (unsigned long long)tripleSixes.value);
+    for (int p = 0; p < players; p++) {
+        fprintf(f, "seat_wins,%d,%llu\n", p, (unsigned long long)seatWins[p].value);
+        for (int place = 0; place < players; place++) {
+            fprintf(f, "seat_place,%d:%d,%llu\n", p, place + 1, (unsigned long long)seatPlaces[p][place].value);
+        }
+    }
+    fprintf(f, "game_length_quantile,0.5,%.1f\n", gameLengthSketch.Quantile(0.5));
+    fprintf(f, "game_length_quantile,0.9,%.1f\n", gameLengthSketch.Quantile(0.9));
+    fprintf(f, "game_length_quantile,0.99,%.1f\n", gameLengthSketch.Quantile(0.99));
+    for (int i = 0; i < FixedHistogram::BUCKETS; i++) {
+        fprintf(f, "game_length_bucket,%d,%llu\n", i * gameLength.width, (unsigned long long)gameLength.counts[i]);
+    }
+    fprintf(f, "game_length_bucket,overflow,%llu\n", (unsigned long long)gameLength.overflow);
+    for (int c = 0; c < trackCells; c++) {
+        fprintf(f, "captures_by_square,%d,%llu\n", c, (unsigned long long)capturesBySquare[c].value);
+    }
+}
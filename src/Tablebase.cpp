@@ -0,0 +1,155 @@
+/**
+ * @file Tablebase.cpp
+ * @brief Endgame table indexing and the memory-mapped reader
+ *
+ * A player's configuration is the sorted multiset of its token positions
+ * plus the home-entry flag. Players that may not enter home can only be on
+ * positions 0..52, so those configurations are numbered first, followed by
+ * the configurations over all 59 positions.
+ */
+
+#include "../include/Tablebase.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <mutex>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const int VALUES_NO_HOME = TRACK_LENGTH + 1;   // Yard plus track
+const int VALUES_HOME = POS_FINISHED + 1;      // Every position
+
+/**
+ * @brief Number of multisets of a given size over a number of values
+ */
+int Multisets(int values, int tokens) {
+    return tokens == 1 ? values : values * (values + 1) / 2;
+}
+
+} // namespace
+
+int EndgameConfigCount(int tokens) {
+    return Multisets(VALUES_NO_HOME, tokens) + Multisets(VALUES_HOME, tokens);
+}
+
+int EndgameConfigIndex(const uint8_t* pos, int tokens, bool canGoHome) {
+    int limit = canGoHome ? VALUES_HOME : VALUES_NO_HOME;
+    int base = canGoHome ? Multisets(VALUES_NO_HOME, tokens) : 0;
+    int a = pos[0];
+    if (tokens == 1) return a < limit ? base + a : -1;
+
+    int b = pos[1];
+    if (a > b) std::swap(a, b);
+    if (b >= limit) return -1;
+    return base + b * (b + 1) / 2 + a;
+}
+
+void EndgameConfigDecode(int index, int tokens, uint8_t* pos, bool& canGoHome) {
+    int split = Multisets(VALUES_NO_HOME, tokens);
+    canGoHome = index >= split;
+    if (canGoHome) index -= split;
+
+    if (tokens == 1) {
+        pos[0] = (uint8_t)index;
+        return;
+    }
+    int b = 0;
+    while ((b + 1) * (b + 2) / 2 <= index) b++;
+    pos[0] = (uint8_t)(index - b * (b + 1) / 2);
+    pos[1] = (uint8_t)b;
+}
+
+uint64_t EndgameEntryIndex(int configCount, int offset, int phase, int mover, int opponent) {
+    uint64_t block = (uint64_t)((offset - 1) * 2 + phase);
+    return (block * configCount + mover) * configCount + opponent;
+}
+
+Tablebase::Tablebase() : map(nullptr), mapSize(0), data(nullptr), numTokens(0), configCount(0) {}
+
+Tablebase::~Tablebase() {
+    Close();
+}
+
+bool Tablebase::Open(const char* path) {
+    Close();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TablebaseHeader)) {
+        close(fd);
+        return false;
+    }
+    void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED) return false;
+
+    // Validate the header in place; the values are used straight from the mapping
+    const TablebaseHeader* h = (const TablebaseHeader*)m;
+    uint64_t expected = 3ULL * 2 * h->configCount * h->configCount;
+    bool valid = h->magic == TABLEBASE_MAGIC &&
+                 h->version == TABLEBASE_VERSION &&
+                 h->numTokens >= 1 && h->numTokens <= TABLEBASE_MAX_TOKENS &&
+                 (int)h->configCount == EndgameConfigCount(h->numTokens) &&
+                 h->entryCount == expected &&
+                 h->dataOffset + expected * sizeof(uint16_t) <= (uint64_t)st.st_size;
+    if (!valid) {
+        munmap(m, st.st_size);
+        return false;
+    }
+
+    map = m;
+    mapSize = st.st_size;
+    numTokens = h->numTokens;
+    configCount = h->configCount;
+    data = (const uint16_t*)((const uint8_t*)m + h->dataOffset);
+    return true;
+}
+
+void Tablebase::Close() {
+    if (map != nullptr) {
+        munmap(map, mapSize);
+    }
+    map = nullptr;
+    mapSize = 0;
+    data = nullptr;
+    numTokens = 0;
+    configCount = 0;
+}
+
+float Tablebase::Lookup(int offset, int phase, int mover, int opponent) const {
+    return data[EndgameEntryIndex(configCount, offset, phase, mover, opponent)] / (float)TABLEBASE_SCALE;
+}
+
+float Tablebase::AfterTurn(const LudoState& s, int mover, int opponent, int phase) const {
+    if (!IsOpen() || s.numTokens != numTokens) return -1.0f;
+
+    bool moverDone = true;
+    for (int t = 0; t < numTokens; t++) {
+        if (s.pos[mover][t] != POS_FINISHED) moverDone = false;
+    }
+    if (moverDone) return 1.0f;
+
+    int a = EndgameConfigIndex(s.pos[mover], numTokens, s.homeMask & (1 << mover));
+    int b = EndgameConfigIndex(s.pos[opponent], numTokens, s.homeMask & (1 << opponent));
+    if (a < 0 || b < 0) return -1.0f;
+
+    int offset = (opponent - mover + CLASSIC_PLAYERS) % CLASSIC_PLAYERS;
+    auto value = [this](int o, int ph, int m, int op) { return (double)Lookup(o, ph, m, op); };
+    return (float)EndgameContinuation(value, a, b, offset, phase);
+}
+
+const Tablebase* GetTablebase(int tokens) {
+    static Tablebase tables[TABLEBASE_MAX_TOKENS + 1];
+    static std::once_flag opened[TABLEBASE_MAX_TOKENS + 1];
+    if (tokens < 1 || tokens > TABLEBASE_MAX_TOKENS) return nullptr;
+
+    std::call_once(opened[tokens], [tokens]() {
+        std::string path = "assets/endgame-" + std::to_string(tokens) + ".tb";
+        tables[tokens].Open(path.c_str());
+    });
+    return tables[tokens].IsOpen() ? &tables[tokens] : nullptr;
+}
@@ -1,5 +1,7 @@
 #include "../include/Token.h"
 #include "../include/Utils.h"
+#include "../include/Rules.h"
+#include "../include/Metrics.h"
 #include <iostream>
 
 /**
@@ -12,53 +14,42 @@ Token::Token() {
     finished = false;
     gridPos = std::make_tuple(-1, -1, -1);
     isOut = false;
-    canGoHome = false;
+    canGoHome = !GameRules::CAPTURE_TO_ENTER_HOME;
     id = -1;
     x = y = initX = initY = 0;
+    sprite = 0;
+    tint = WHITE;
+    tween = nullptr;
 }
 
 /**
- * @brief Sets the token's texture and resets its state
- * @param t The texture to apply to this token
+ * @brief Sets the token's atlas frame and resets its state
+ * @param frame Frame of the token atlas to draw
+ * @param c Tint, so seats beyond the four images get their own color
  */
-void Token::setTexture(Texture2D t) {
+void Token::setSprite(int frame, Color c) {
     sem_init(&semToken, 0, 0);
     isSafe = true;
     gridPos = std::make_tuple(-1, -1, -1);
     isOut = false;
-    canGoHome = false;
+    canGoHome = !GameRules::CAPTURE_TO_ENTER_HOME;
     finished = false;
     id = -1;
     x = y = 0;
-    token = t;
+    sprite = frame;
+    tint = c;
+    tween = nullptr;  // The pool was cleared with the last match
 }
 
 /**
  * @brief Sets the token's starting position based on player ID
- * @param i The player ID (0-3) determining start position
+ * @param i The player ID determining start position
  */
 void Token::setStart(int i) {
     id = i;
-    switch (id) {
-        case 0:  // Left player
-            x = 60;
-            y = 360;
-            break;
-        case 1:  // Top player
-            x = 480;
-            y = 60;
-            break;
-        case 2:  // Right player
-            x = 780;
-            y = 480;
-            break;
-        case 3:  // Bottom player
-            x = 360;
-            y = 780;
-            break;
-        default:
-            break;
-    }
+    BoardPoint p = Board(activeBoard).Pixel(id, POS_START);
+    x = p.x;
+    y = p.y;
 }
 
 /**
@@ -66,7 +57,7 @@ void Token::setStart(int i) {
  * Updates the global LudoGrid with token's current position and checks if position is safe
  */
 void Token::updateGrid() {
-    LudoGrid[id][gridID] = gridPos;
+    SetGrid(id, gridID, gridPos);
     if (isTokenSafe(gridPos))
         isSafe = true;
     else
@@ -74,14 +65,46 @@ void Token::updateGrid() {
 }
 
 /**
- * @brief Draws the token at its current or initial position
- * Renders token texture based on whether it's in play or at home
+ * @brief Queues the token at its current or initial position
+ * Picks the spot based on whether it's in play or at home; a token still
+ * walking its last move is drawn on the way and a finished one not at all.
+ * Nothing is drawn until the batch is submitted
  */
-void Token::drawInit() {
-    if (isOut == false && !finished)
-        DrawTexture(token, initX, initY, WHITE);
-    else {
-        DrawTexture(token, x, y, WHITE);
+void Token::draw(TokenBatch& batch) {
+    Vector2 at;
+    if (tween == nullptr || !tween->Sample(MetricsNowNs(), at.x, at.y)) {
+        stopAnimation();
+        if (finished)
+            return;  // Off the board
+        if (isOut == false)
+            at = {(float)initX, (float)initY};
+        else
+            at = {(float)x, (float)y};
+    }
+    batch.Add(at.x, at.y, sprite, tint);
+}
+
+/**
+ * @brief Starts a tween from the pool along the path of a move
+ * The rules state is already updated; only the drawing lags behind
+ */
+void Token::animate(int from, int to) {
+    if (tween == nullptr) tween = tweenPool.Acquire();
+    if (tween == nullptr)
+        return;  // Pool exhausted; the token jumps
+
+    const BoardGeometry& g = Board(activeBoard);
+    BoardPoint start = from == POS_YARD ? BoardPoint{(int16_t)initX, (int16_t)initY} : g.Pixel(id, from);
+    tween->Start(g, id, from, to, start, MetricsNowNs());
+}
+
+/**
+ * @brief Gives the token's tween back to the pool
+ */
+void Token::stopAnimation() {
+    if (tween != nullptr) {
+        tweenPool.Release(tween);
+        tween = nullptr;
     }
 }
 
@@ -92,24 +115,30 @@ void Token::drawInit() {
 void Token::outToken() {
     sem_post(&semToken);
     isOut = true;
-    gridPos = std::make_tuple(id, 2, 1);
-    DrawTexture(token, x, y, WHITE);
+    gridPos = PosToGrid(id, POS_START, activeBoard);
+    animate(POS_YARD, POS_START);
 }
 
 /**
  * @brief Returns token to starting position
- * Waits on semaphore and resets token state to initial position
+ * Takes back the semaphore count posted by outToken and resets the token.
+ * Runs on the render thread with the game mutex held, so it must not block
  */
 void Token::inToken() {
-    sem_wait(&semToken);
+    if (sem_trywait(&semToken) != 0) {
+        std::cout << "Token returned home without a matching outToken" << std::endl;
+    }
     isOut = false;
+    stopAnimation();
     setStart(id);
     gridPos = std::make_tuple(-1, -1, -1);
 }
 
 /**
  * @brief Moves the token based on dice roll
- * Handles complex movement logic including:
+ * Looks the destination up in the rules engine and the board's pixel
+ * tables, so a move costs the same on every board. x and y jump to the
+ * destination at once; the token is drawn walking there by its tween:
  * - Path following around board
  * - Entering home stretch
  * - Reaching final position
@@ -120,241 +149,24 @@ void Token::inToken() {
 void Token::move(int roll) {
     if (roll == 0)
         return;
-    std::cout << "\nDice Val " << roll << std::endl;
-    
-    // Extract current grid position components
-    int g = std::get<0>(gridPos);  // Grid quadrant (0-3)
-    int r = std::get<1>(gridPos);  // Row position
-    int c = std::get<2>(gridPos);  // Column position
-    
-    std::cout << "Grid: " << g
-         << " Row: " << r
-         << " Col: " << c << std::endl;
-         
-    // Calculate movement overflow
-    int next = 0, cur = 0;
-    std::cout << "C+Roll " << c + roll << std::endl;
-    if (c + roll >= 5) {
-        next = (c + roll) - 5;  // Spaces to move after current segment
-        cur = roll - next;      // Spaces to move in current segment
-        std::cout << "Next: " << next
-             << " Cur: " << cur << std::endl;
-    }
-    else {
-        cur = roll;
-    }
 
-    // Handle movement based on current grid quadrant and row
-    switch (g) {
-        case 0:  // Left quadrant
-            switch (r) {
-                case 0:  // Top row
-                    x = x - (cur * 60);
-                    std::get<2>(gridPos) = c + cur;
-                    if (next >= 1) {
-                        y = y - 60;
-                        next--;
-                        std::get<1>(gridPos) = 1;
-                        std::get<2>(gridPos) = 0;
-                        move(next);
-                    }
-                    break;
-                case 1:  // Home stretch
-                    if (canGoHome && id == std::get<0>(gridPos)) {
-                        if (roll + c <= 6) {
-                            x = x + (roll * 60);
-                            std::get<2>(gridPos) = c + roll;
-                            if (std::get<2>(gridPos) == 6) {
-                                sem_destroy(&semToken);
-                                isOut = false;
-                                finished = true;
-                                x = -100;
-                                y = -100;
-                            }
-                        }
-                    }
-                    else {
-                        next = 1;
-                        y = y - (next * 60);
-                        cur--;
-                        std::get<1>(gridPos) = 2;
-                        std::get<2>(gridPos) = 0;
-                        move(cur);
-                        return;
-                    }
-                    break;
-                case 2:  // Bottom row
-                    x = x + (cur * 60);
-                    std::get<2>(gridPos) = c + cur;
-                    if (next != 0) {
-                        x += 60;
-                        y = y - (next * 60);
-                        std::get<0>(gridPos) = 1;
-                        std::get<1>(gridPos) = 0;
-                        std::get<2>(gridPos) = next - 1;
-                    }
-                    break;
-                default:
-                    break;
-            }
-            break;
-        case 1:  // Top quadrant
-            switch (r) {
-                case 0:  // Left row
-                    y = y - (cur * 60);
-                    std::get<2>(gridPos) = c + cur;
-                    if (next >= 1) {
-                        x = x + 60;
-                        next--;
-                        std::get<1>(gridPos) = 1;
-                        std::get<2>(gridPos) = 0;
-                        move(next);
-                    }
-                    break;
-                case 1:  // Home stretch
-                    if (canGoHome && id == std::get<0>(gridPos)) {
-                        if (roll + c <= 6) {
-                            y = y + (roll * 60);
-                            std::get<2>(gridPos) = c + roll;
-                            if (std::get<2>(gridPos) == 6) {
-                                sem_destroy(&semToken);
-                                finished = true;
-                                isOut = false;
-                                x = -100;
-                                y = -100;
-                            }
-                        }
-                    }
-                    else {
-                        next = 1;
-                        x = x + (next * 60);
-                        cur--;
-                        std::get<1>(gridPos) = 2;
-                        std::get<2>(gridPos) = 0;
-                        move(cur);
-                        return;
-                    }
-                    break;
-                case 2:  // Right row
-                    y = y + (cur * 60);
-                    std::get<2>(gridPos) = c + cur;
-                    if (next != 0) {
-                        y += 60;
-                        x = x + (next * 60);
-                        std::get<0>(gridPos) = 2;
-                        std::get<1>(gridPos) = 0;
-                        std::get<2>(gridPos) = next - 1;
-                    }
-                    break;
-                default:
-                    break;
-            }
-            break;
-        case 2:  // Right quadrant
-            switch (r) {
-                case 0:  // Bottom row
-                    x = x + (cur * 60);
-                    std::get<2>(gridPos) = c + cur;
-                    if (next >= 1) {
-                        y = y + 60;
-                        next--;
-                        std::get<1>(gridPos) = 1;
-                        std::get<2>(gridPos) = 0;
-                        move(next);
-                    }
-                    break;
-                case 1:  // Home stretch
-                    if (canGoHome && id == std::get<0>(gridPos)) {
-                        if (roll + c <= 6) {
-                            x = x - (roll * 60);
-                            std::get<2>(gridPos) = c + roll;
-                            if (std::get<2>(gridPos) == 6) {
-                                sem_destroy(&semToken);
-                                finished = true;
-                                isOut = false;
-                                x = -100;
-                                y = -100;
-                            }
-                        }
-                    }
-                    else {
-                        next = 1;
-                        y = y + (next * 60);
-                        cur--;
-                        std::get<1>(gridPos) = 2;
-                        std::get<2>(gridPos) = 0;
-                        move(cur);
-                        return;
-                    }
-                    break;
-                case 2:  // Top row
-                    x = x - (cur * 60);
-                    std::get<2>(gridPos) = c + cur;
-                    if (next != 0) {
-                        x -= 60;
-                        y = y + (next * 60);
-                        std::get<0>(gridPos) = 3;
-                        std::get<1>(gridPos) = 0;
-                        std::get<2>(gridPos) = next - 1;
-                    }
-                    break;
-                default:
-                    break;
-            }
-            break;
-        case 3:  // Bottom quadrant
-            switch (r) {
-                case 0:  // Right row
-                    y = y + (cur * 60);
-                    std::get<2>(gridPos) = c + cur;
-                    if (next >= 1) {
-                        x = x - 60;
-                        next--;
-                        std::get<1>(gridPos) = 1;
-                        std::get<2>(gridPos) = 0;
-                        move(next);
-                    }
-                    break;
-                case 1:  // Home stretch
-                    if (canGoHome && id == std::get<0>(gridPos)) {
-                        if (roll + c <= 6) {
-                            y = y - (roll * 60);
-                            std::get<2>(gridPos) = c + roll;
-                            if (std::get<2>(gridPos) == 6) {
-                                sem_destroy(&semToken);
-                                finished = true;
-                                isOut = false;
-                                x = -100;
-                                y = -100;
-                            }
-                        }
-                    }
-                    else {
-                        next = 1;
-                        x = x - (next * 60);
-                        cur--;
-                        std::get<1>(gridPos) = 2;
-                        std::get<2>(gridPos) = 0;
-                        move(cur);
-                        return;
-                    }
-                    break;
-                case 2:  // Left row
-                    y = y - (cur * 60);
-                    std::get<2>(gridPos) = c + cur;
-                    if (next != 0) {
-                        y -= 60;
-                        x = x - (next * 60);
-                        std::get<0>(gridPos) = 0;
-                        std::get<1>(gridPos) = 0;
-                        std::get<2>(gridPos) = next - 1;
-                    }
-                    break;
-                default:
-                    break;
-            }
-            break;
-        default:
-            break;
+    const BoardGeometry& g = Board(activeBoard);
+    int from = GridToPos(id, gridPos, activeBoard);
+    int to = MoveTarget<GameRules>(g, from, roll, canGoHome);
+    if (to < 0)
+        return;  // Only legal moves are offered, see Player::legalMoves
+
+    gridPos = PosToGrid(id, to, activeBoard);
+    animate(from, to);
+    if (to == g.finished) {
+        sem_destroy(&semToken);
+        isOut = false;
+        finished = true;
+        x = -100;
+        y = -100;
+        return;
     }
-} 
\ No newline at end of file
+    BoardPoint p = g.Pixel(id, to);
+    x = p.x;
+    y = p.y;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file TokenBatch.cpp
+ * @brief Token atlas packing and single-batch token drawing
+ */
+
+#include "../include/TokenBatch.h"
+#include "rlgl.h"
+#include <iostream>
+
+TokenBatch::TokenBatch() : sheet{}, atlas{}, frames(0), frameWidth(0), frameHeight(0), atlasWidth(0), count(0) {}
+
+bool TokenBatch::Load(const char* const* paths, int n) {
+    Unload();
+    if (n > MAX_FRAMES) n = MAX_FRAMES;
+    Image images[MAX_FRAMES];
+    bool ok = true;
+    for (int i = 0; i < n; i++) {
+        images[i] = LoadImage(paths[i]);
+        if (images[i].data == nullptr) {
+            std::cout << "Failed to load token image " << paths[i] << std::endl;
+            ok = false;
+        } else if (frameWidth == 0) {
+            frameWidth = images[i].width;
+            frameHeight = images[i].height;
+        }
+    }
+    if (frameWidth == 0) return false;
+
+    // Frames sit side by side; one that failed to load stays transparent
+    sheet = GenImageColor(frameWidth * n, frameHeight, BLANK);
+    for (int i = 0; i < n; i++) {
+        if (images[i].data == nullptr) continue;
+        if (images[i].width != frameWidth || images[i].height != frameHeight)
+            ImageResize(&images[i], frameWidth, frameHeight);
+        Rectangle src = {0, 0, (float)frameWidth, (float)frameHeight};
+        Rectangle dst = {(float)(i * frameWidth), 0, (float)frameWidth, (float)frameHeight};
+        ImageDraw(&sheet, images[i], src, dst, WHITE);
+        UnloadImage(images[i]);
+    }
+    frames = n;
+    return ok;
+}
+
+void TokenBatch::Rescale(int pixelWidth) {
+    if (sheet.data == nullptr || pixelWidth < 1 || pixelWidth == atlasWidth) return;
+    if (atlas.id != 0) UnloadTexture(atlas);
+    Image scaled = ImageCopy(sheet);
+    ImageResize(&scaled, pixelWidth * frames, pixelWidth * frameHeight / frameWidth);
+    atlas = LoadTextureFromImage(scaled);
+    UnloadImage(scaled);
+    SetTextureFilter(atlas, TEXTURE_FILTER_BILINEAR);
+    atlasWidth = pixelWidth;
+}
+
+void TokenBatch::Unload() {
+    if (atlas.id != 0) UnloadTexture(atlas);
+    if (sheet.data != nullptr) UnloadImage(sheet);
+    atlas = Texture2D{};
+    sheet = Image{};
+    frames = frameWidth = frameHeight = atlasWidth = 0;
+    count = 0;
+}
+
+void TokenBatch::Add(float x, float y, int frame, Color tint) {
+    if (count == CAPACITY) return;
+    sprites[count++] = {x, y, frame, tint};
+}
+
+void TokenBatch::Draw(float width) const {
+    if (count == 0 || atlas.id == 0) return;
+    float height = width * frameHeight / frameWidth;
+    float du = 1.0f / frames;
+
+    // Same vertex layout as DrawTexturePro, but every token in one rlBegin
+    rlCheckRenderBatchLimit(4 * count);
+    rlSetTexture(atlas.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    for (int i = 0; i < count; i++) {
+        const Sprite& s = sprites[i];
+        float u0 = s.frame * du, u1 = u0 + du;
+        rlColor4ub(s.tint.r, s.tint.g, s.tint.b, s.tint.a);
+        rlTexCoord2f(u0, 0.0f);
+        rlVertex2f(s.x, s.y);
+        rlTexCoord2f(u0, 1.0f);
+        rlVertex2f(s.x, s.y + height);
+        rlTexCoord2f(u1, 1.0f);
+        rlVertex2f(s.x + width, s.y + height);
+        rlTexCoord2f(u1, 0.0f);
+        rlVertex2f(s.x + width, s.y);
+    }
+    rlEnd();
+    rlSetTexture(0);
+}
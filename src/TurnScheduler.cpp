@@ -0,0 +1,126 @@
+/**
+ * @file TurnScheduler.cpp
+ * @brief Cooperative scheduler for player turn coroutines
+ */
+
+#include "../include/TurnScheduler.h"
+#include <new>
+#include <pthread.h>
+
+namespace {
+
+const int FRAME_SIZES = 8;   // Distinct coroutine frame sizes that are recycled
+
+/**
+ * @brief Free lists of finished coroutine frames, one per frame size
+ *
+ * A freed frame stores the pointer to the next free frame in its first
+ * bytes, so recycling never allocates. Frames are created on the render
+ * thread and may be destroyed on the scheduler thread, hence the lock.
+ */
+struct FramePool {
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    std::size_t sizes[FRAME_SIZES] = {};
+    void* heads[FRAME_SIZES] = {};
+};
+
+FramePool framePool;
+
+} // namespace
+
+void* TurnTask::promise_type::operator new(std::size_t size) {
+    pthread_mutex_lock(&framePool.lock);
+    for (int i = 0; i < FRAME_SIZES; i++) {
+        if (framePool.sizes[i] == size && framePool.heads[i] != nullptr) {
+            void* frame = framePool.heads[i];
+            framePool.heads[i] = *(void**)frame;
+            pthread_mutex_unlock(&framePool.lock);
+            return frame;
+        }
+    }
+    pthread_mutex_unlock(&framePool.lock);
+    return ::operator new(size);
+}
+
+void TurnTask::promise_type::operator delete(void* frame, std::size_t size) {
+    pthread_mutex_lock(&framePool.lock);
+    for (int i = 0; i < FRAME_SIZES; i++) {
+        if (framePool.sizes[i] == 0) framePool.sizes[i] = size;
+        if (framePool.sizes[i] == size) {
+            *(void**)frame = framePool.heads[i];
+            framePool.heads[i] = frame;
+            pthread_mutex_unlock(&framePool.lock);
+            return;
+        }
+    }
+    pthread_mutex_unlock(&framePool.lock);
+    ::operator delete(frame);
+}
+
+TurnTask& TurnTask::operator=(TurnTask&& other) noexcept {
+    if (this != &other) {
+        if (handle) handle.destroy();
+        handle = other.handle;
+        other.handle = nullptr;
+    }
+    return *this;
+}
+
+TurnTask::~TurnTask() {
+    if (handle) handle.destroy();
+}
+
+TurnScheduler::TurnScheduler() {}
+
+void TurnScheduler::Spawn(TurnTask task) {
+    next.push_back(task.handle);
+    tasks.push_back(std::move(task));
+}
+
+void TurnScheduler::Park(int seat, std::coroutine_handle<> h) {
+    if (seat >= (int)parked.size()) {
+        parked.resize(seat + 1, nullptr);
+    }
+    parked[seat] = h;
+}
+
+void TurnScheduler::Wake(int seat) {
+    if (seat < 0 || seat >= (int)parked.size() || !parked[seat]) return;
+    next.push_back(parked[seat]);
+    parked[seat] = nullptr;
+}
+
+void TurnScheduler::WakeAll() {
+    for (int seat = 0; seat < (int)parked.size(); seat++) {
+        Wake(seat);
+    }
+}
+
+int TurnScheduler::Tick() {
+    // Swap so coroutines that yield during this tick run on the next one
+    ready.swap(next);
+    int resumed = 0;
+    for (std::coroutine_handle<> h : ready) {
+        if (!h.done()) {
+            h.resume();
+            resumed++;
+        }
+    }
+    ready.clear();
+    return resumed;
+}
+
+void TurnScheduler::Clear() {
+    ready.clear();
+    next.clear();
+    parked.clear();
+    tasks.clear();
+}
+
+int TurnScheduler::Active() const {
+    int count = 0;
+    for (const TurnTask& t : tasks) {
+        if (!t.done()) count++;
+    }
+    return count;
+}
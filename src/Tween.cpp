@@ -0,0 +1,68 @@
+/**
+ * @file Tween.cpp
+ * @brief Token move animation and its fixed tween pool
+ */
+
+#include "../include/Tween.h"
+
+void Tween::Start(const BoardGeometry& g, int player, int from, int to, BoardPoint start, uint64_t now) {
+    path[0] = start;
+    steps = 0;
+    startNs = now;
+    if (from == POS_YARD) {
+        path[++steps] = g.Pixel(player, to);
+        return;
+    }
+
+    // A move that ends in the home column turns off the track at the tip
+    int pos = from;
+    while (pos != to && steps < TWEEN_MAX_STEPS) {
+        if (pos == g.tip && to >= g.homeFirst) pos = g.homeFirst;
+        else if (pos == g.trackLength) pos = POS_START;
+        else pos++;
+        path[++steps] = g.Pixel(player, pos);
+    }
+    if (pos != to) path[steps] = g.Pixel(player, to);
+}
+
+bool Tween::Sample(uint64_t now, float& x, float& y) const {
+    uint64_t elapsed = now > startNs ? now - startNs : 0;
+    uint64_t step = elapsed / TWEEN_STEP_NS;
+    if (step >= (uint64_t)steps) {
+        x = path[steps].x;
+        y = path[steps].y;
+        return false;
+    }
+    float f = (float)(elapsed % TWEEN_STEP_NS) / TWEEN_STEP_NS;
+    const BoardPoint& a = path[step];
+    const BoardPoint& b = path[step + 1];
+    x = a.x + (b.x - a.x) * f;
+    y = a.y + (b.y - a.y) * f;
+    return true;
+}
+
+TweenPool::TweenPool() {
+    Clear();
+}
+
+Tween* TweenPool::Acquire() {
+    Tween* t = freeList;
+    if (t == nullptr) return nullptr;
+    freeList = t->nextFree;
+    inUse++;
+    return t;
+}
+
+void TweenPool::Release(Tween* t) {
+    t->nextFree = freeList;
+    freeList = t;
+    inUse--;
+}
+
+void TweenPool::Clear() {
+    for (int i = 0; i < CAPACITY; i++) {
+        tweens[i].nextFree = i + 1 < CAPACITY ? &tweens[i + 1] : nullptr;
+    }
+    freeList = &tweens[0];
+    inUse = 0;
+}
@@ -1,14 +1,37 @@
 #include "../include/Utils.h"
+#include "../include/Metrics.h"
 #include <algorithm>
+#include <cstring>
 #include <random>
 
 // Global game state variables
 /** Number of tokens in play, initialized to -1 */
 int numTokens = -1;
 
+/** Board of the current match, the classic board until another is picked */
+int activeBoard = BOARD_CLASSIC;
+
 /** 2D array storing 3D coordinates for board positions */
 std::tuple<int, int, int> **LudoGrid;
 
+/** Arena holding LudoGrid and the players' tokens for the current match */
+MatchArena matchArena;
+
+/** Token positions and cell occupancy of the current match */
+LudoState matchState;
+
+/** Dice and moves of the current match */
+MatchRecord matchRecord;
+
+/** Click hit-test index: tokens on every board spot */
+uint8_t spotTokens[BOARD_MAX_SPOTS][BOARD_MAX_ARMS];
+
+/** Tweens for the token moves being animated */
+TweenPool tweenPool;
+
+/** Click seen by the current logic tick */
+TickInput tickInput = {false, 0, 0};
+
 /** Vector storing last 3 dice rolls */
 std::vector<int> diceVal(3, 0);
 
@@ -24,7 +47,7 @@ bool movePlayer = false;
 /** Flag controlling if dice can be rolled */
 bool moveDice = true;
 
-/** ID of player whose turn it currently is (1-4) */
+/** ID of player whose turn it currently is (1-based seat) */
 int turn = 1;
 
 /** ID of player who had the previous turn */
@@ -40,33 +63,86 @@ std::vector<int> winners;
  * @brief Determines if a given board position is a safe spot
  * 
  * Safe spots are special positions on the board where tokens cannot be captured.
- * These are located at coordinates (i,2,1) and (i,0,3) for each player i.
+ * The board marks the safe track cells, (i,2,1) and (i,0,3) for each arm i on
+ * the built-in boards, and GameRules decides whether they count. The yard and
+ * home columns never are.
  *
  * @param g Tuple containing 3D coordinates (x,y,z) of position to check
  * @return true if position is a safe spot, false otherwise
  */
 bool isTokenSafe(std::tuple<int, int, int> g) {
-    for (int i = 0; i < 4; i++) {
-        if (g == std::make_tuple(i, 2, 1) || g == std::make_tuple(i, 0, 3))
-            return true;
+    int quadrant = std::get<0>(g);
+    int row = std::get<1>(g);
+    int col = std::get<2>(g);
+    if (quadrant < 0 || (row == 1 && col >= 1)) return false;
+    const BoardGeometry& board = Board(activeBoard);
+    int inArm = row == 0 ? col : (row == 1 ? board.lane : board.lane + 1 + col);
+    return IsSafeCell<GameRules>(board, quadrant * board.armLength + inArm);
+}
+
+void ResetGrid() {
+    const BoardGeometry& board = Board(activeBoard);
+    InitState(matchState, numTokens, 0, activeBoard);
+    memset(spotTokens, 0, sizeof(spotTokens));
+    for (int p = 0; p < board.arms; p++) {
+        for (int k = 0; k < numTokens; k++) {
+            LudoGrid[p][k] = std::make_tuple(-1, -1, -1);
+            spotTokens[board.Spot(p, k, POS_YARD)][p] |= (uint8_t)(1 << k);
+        }
     }
-    return false;
+    matchRecord.Start(matchState);
+}
+
+/**
+ * @brief Moves a token on the shared grid
+ *
+ * matchState and spotTokens follow every move, so collisions, legal moves
+ * and clicks read the occupancy of one cell instead of comparing every
+ * token of every player.
+ */
+void SetGrid(int player, int token, const std::tuple<int, int, int>& g) {
+    if (LudoGrid[player][token] == g) return;
+    LudoGrid[player][token] = g;
+
+    const BoardGeometry& board = Board(activeBoard);
+    int from = board.Spot(player, token, matchState.pos[player][token]);
+    int pos = GridToPos(player, g, activeBoard);
+    PlaceToken(matchState, player, token, pos);
+    int to = board.Spot(player, token, pos);
+    if (from >= 0) spotTokens[from][player] &= (uint8_t)~(1 << token);
+    if (to >= 0) spotTokens[to][player] |= (uint8_t)(1 << token);
+}
+
+/**
+ * @brief Puts the shared match state back to its start-of-match values
+ */
+void ResetMatchState() {
+    diceVal.assign(3, 0);
+    diceCount = 0;
+    dice = 1;
+    movePlayer = false;
+    moveDice = true;
+    turn = 1;
+    lastTurn = turn;
+    nextTurn.clear();
+    winners.clear();
 }
 
 /**
  * @brief Generates a random sequence of player turns
  * 
- * Creates a vector of 4 unique random numbers between 1-4 representing
- * the order in which players will take their turns. This ensures fair
- * and random turn distribution among players.
+ * Creates a vector of unique random numbers between 1 and the number of
+ * seats on the board, representing the order in which players will take
+ * their turns. This ensures fair and random turn distribution among players.
  */
 void GenerateTurns() {
-    nextTurn.resize(4);
-    int r = (rand() % 4) + 1;
+    int seats = Board(activeBoard).arms;
+    nextTurn.assign(seats, 0);
+    int r = (rand() % seats) + 1;
     int count = 0;
-    while (count != 4) {
+    while (count != seats) {
         if (std::find(nextTurn.begin(), nextTurn.end(), r) != nextTurn.end()) {
-            r = (rand() % 4) + 1;
+            r = (rand() % seats) + 1;
         } else {
             nextTurn[count] = r;
             count++;
@@ -83,9 +159,10 @@ void GenerateTurns() {
  * 3. Skipping players who have already won
  * 4. Regenerating turn sequence if exhausted
  *
- * @return int Player ID (1-4) whose turn is next
+ * @return int Player ID (1-based seat) whose turn is next
  */
 int getTurn() {
+    metrics.turns.Add();
     int t;
     if (nextTurn.empty()) {
         GenerateTurns();
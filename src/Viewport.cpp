@@ -0,0 +1,84 @@
+/**
+ * @file Viewport.cpp
+ * @brief Logical canvas to window mapping and textures cached per resolution
+ */
+
+#include "../include/Viewport.h"
+#include <iostream>
+
+Viewport::Viewport(int w, int h)
+    : width(w), height(h), windowWidth(0), windowHeight(0), dpi(0.0f), scale(1.0f), pixelScale(1.0f),
+      offset{0.0f, 0.0f} {}
+
+bool Viewport::Update() {
+    int w = GetScreenWidth();
+    int h = GetScreenHeight();
+    float d = GetWindowScaleDPI().x;
+    if (d <= 0.0f) d = 1.0f;
+    if (w <= 0 || h <= 0 || (w == windowWidth && h == windowHeight && d == dpi))
+        return false;  // Unchanged, or minimized: keep the assets for when it comes back
+
+    windowWidth = w;
+    windowHeight = h;
+    dpi = d;
+    float sx = (float)w / width, sy = (float)h / height;
+    scale = sx < sy ? sx : sy;
+    pixelScale = scale * dpi;
+    offset = {(w - width * scale) / 2.0f, (h - height * scale) / 2.0f};
+    return true;
+}
+
+Camera2D Viewport::Camera() const {
+    Camera2D camera = {};
+    camera.offset = offset;
+    camera.zoom = scale;
+    return camera;
+}
+
+Vector2 Viewport::ToLogical(Vector2 window) const {
+    return {(window.x - offset.x) / scale, (window.y - offset.y) / scale};
+}
+
+ScaledTexture::ScaledTexture() : width(0.0f), height(0.0f), source{}, texture{} {}
+
+bool ScaledTexture::Load(const char* path) {
+    Unload();
+    source = LoadImage(path);
+    if (source.data == nullptr) {
+        std::cout << "Failed to load image " << path << std::endl;
+        return false;
+    }
+    width = (float)source.width;
+    height = (float)source.height;
+    return true;
+}
+
+void ScaledTexture::Rescale(float pixelScale) {
+    if (source.data == nullptr) return;
+    if (texture.id != 0) UnloadTexture(texture);
+    int w = (int)(width * pixelScale + 0.5f), h = (int)(height * pixelScale + 0.5f);
+    if (w == source.width && h == source.height) {
+        texture = LoadTextureFromImage(source);
+    } else {
+        Image copy = ImageCopy(source);
+        ImageResize(&copy, w > 0 ? w : 1, h > 0 ? h : 1);
+        texture = LoadTextureFromImage(copy);
+        UnloadImage(copy);
+    }
+    SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);
+}
+
+void ScaledTexture::Unload() {
+    if (texture.id != 0) UnloadTexture(texture);
+    if (source.data != nullptr) UnloadImage(source);
+    texture = Texture2D{};
+    source = Image{};
+    width = height = 0.0f;
+}
+
+void ScaledTexture::Draw(float x, float y, Color tint) const {
+    if (texture.id == 0) return;
+    Rectangle src = {0.0f, 0.0f, (float)texture.width, (float)texture.height};
+    Rectangle dst = {x, y, width, height};
+    DrawTexturePro(texture, src, dst, {0.0f, 0.0f}, 0.0f, tint);
+}
@@ -12,8 +12,11 @@
  */
 
 #include "../include/Game.h"
+#include "../include/LockProfiler.h"
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <iostream>
 
 /**
  * @brief Global mutex for protecting shared game state
@@ -55,9 +58,19 @@ void* Master(void* args) {
  * Initializes the random number generator, creates and manages the game threads,
  * and handles proper cleanup of system resources.
  *
+ * @param argc Argument count
+ * @param argv Optional snapshot file to resume, --board FILE to play on a described board,
+ *             --tick-rate N to run the rules N times per second, --input FILE to play
+ *             from an input script, --lockstep to run one logic tick per frame,
+ *             --seed N to roll the same dice every run and
+ *             --record FILE to write the match's replay there (default multiludo.mlr)
+ *             and --replay FILE to open a recorded match on the replay screen
  * @return 0 on successful execution
+ *
+ * Setting MULTILUDO_LOCK_PROFILE in the environment attributes every lock of
+ * the three mutexes to its call site and prints a contention report at exit.
  */
-int main(void) {
+int main(int argc, char* argv[]) {
     // Seed random number generator for dice rolls
     srand(time(NULL));
     
@@ -65,12 +78,49 @@ int main(void) {
     pthread_mutex_init(&mutex, NULL);
     pthread_mutex_init(&mutexDice, NULL);
     pthread_mutex_init(&mutexTurn, NULL);
+    EnableLockProfiling(getenv("MULTILUDO_LOCK_PROFILE") != NULL);
     
-    // Create and start the master game thread
-    Game game;
-    pthread_t masterThread;
-    pthread_create(&masterThread, NULL, &Master, &game);
-    pthread_join(masterThread, NULL);
+    // Create and start the master game thread. The game is scoped so that its
+    // destructor, which joins a scheduler thread that missed the shutdown
+    // deadline, runs before the mutexes that thread locks are destroyed
+    {
+        Game game;
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--board") == 0 && i + 1 < argc) {
+                // Register before any game thread starts; the match is played on it
+                BoardGeometry board;
+                int id = LoadBoardGeometry(argv[++i], board) ? RegisterBoard(board) : -1;
+                if (id >= 0) game.selectedBoard = id;
+            } else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+                // Faster ticks speed up computer opponents; the animation keeps its pace
+                int rate = atoi(argv[++i]);
+                if (rate > 0) game.schedulerThread.tickRate = rate;
+                else std::cout << "Ignoring --tick-rate " << argv[i] << std::endl;
+            } else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+                // Scripted runs drive menus and matches without anyone at the window
+                if (game.scriptedInput.Load(argv[++i])) game.input = &game.scriptedInput;
+                else return 1;
+            } else if (strcmp(argv[i], "--lockstep") == 0) {
+                // One logic tick per frame, so a script and a seed always replay the same match
+                game.schedulerThread.lockstep = true;
+            } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+                srand((unsigned)strtoul(argv[++i], NULL, 10));
+            } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+                game.replayPath = argv[++i];
+            } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+                game.watchPath = argv[++i];
+            } else {
+                game.resumePath = argv[i];
+            }
+        }
+        pthread_t masterThread;
+        pthread_create(&masterThread, NULL, &Master, &game);
+        pthread_join(masterThread, NULL);
+    }
+
+    if (LockProfilingEnabled()) {
+        WriteLockProfile(stdout);
+    }
     
     // Cleanup and destroy mutexes
     pthread_mutex_destroy(&mutex);
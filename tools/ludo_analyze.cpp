@@ -0,0 +1,313 @@
+/**
+ * @file ludo_analyze.cpp
+ * @brief Move-by-move analysis of a recorded match
+ *
+ * Plays a replay back to rebuild the position before every move, then
+ * scores the move that was played against every alternative for the same
+ * die. A move is valued by the best use of the rest of the seat's dice,
+ * followed by one turn of every opponent replying greedily to each dice
+ * outcome, with the trained evaluator scoring the positions reached. The
+ * loss of a move is how far its value falls short of the best one, in
+ * finishing places (1 is the gap between first and last).
+ *
+ * Positions are independent once rebuilt, so they are handed out to a
+ * pool of worker threads one at a time and the report is written in match
+ * order after the join.
+ *
+ * Usage: ludo_analyze <replay file> [options]
+ *   --weights FILE     Evaluator weights (default assets/evaluator.bin)
+ *   --threads N        Worker threads (default: all cores)
+ *   --inaccuracy X     Loss from which a move is reported (default 0.02)
+ *   --blunder X        Loss from which a move is a blunder (default 0.05)
+ *   --csv FILE         Write every analysed move here ("-" for stdout)
+ */
+
+#include "../include/Bot.h"
+#include "../include/Evaluator.h"
+#include "../include/Replay.h"
+#include "../include/Simulator.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/** @brief Reasons a reported move is worse than its best alternative */
+enum MoveTag {
+    TAG_LEFT_SAFE = 1,          ///< Left a safe square for one an opponent can hit
+    TAG_EXPOSED = 2,            ///< Landed where an opponent can hit it; the best move did not
+    TAG_MISSED_CAPTURE = 4,     ///< Another move captured
+    TAG_MISSED_FINISH = 8       ///< Another move finished a token
+};
+
+/** @brief A position where a seat chose a move */
+struct Position {
+    LudoState before;           ///< Position before the move
+    int event;                  ///< Index of the event in the record
+    int turn;                   ///< 1-based turn of the match
+    int player;                 ///< Seat that moved
+    int dice[RULES_MAX_DICE];   ///< Seat's dice queue, the die used first
+    int numDice;                ///< Dice in the queue
+    int played;                 ///< Token that was moved
+};
+
+/** @brief Verdict on one position */
+struct Analysis {
+    int candidates;             ///< Legal moves for the die
+    int best;                   ///< Token of the best move
+    float playedValue;          ///< Value of the move played
+    float bestValue;            ///< Value of the best move
+    int tags;                   ///< Combination of MoveTag
+};
+
+/** @brief Evaluator the positions are scored with */
+Evaluator evaluator;
+
+/**
+ * @brief Value once the player's dice are spent: the opponents' greedy replies, averaged
+ */
+double ReplyValue(const LudoState& s, int player) {
+    if (SimAllFinished(s, player)) return 1.0;
+    double total = 0.0;
+    int opponents = 0;
+    for (int q = 0; q < s.numPlayers; q++) {
+        if (q == player || SimAllFinished(s, q)) continue;
+        opponents++;
+        for (int o = 0; o < TURN_DICE_COUNT; o++) {
+            LudoState next = s;
+            SimGreedyTurn(next, q, TURN_DICE[o].dice, TURN_DICE[o].count);
+            total += TURN_DICE[o].prob * SimPositionValue(evaluator, next, player);
+        }
+    }
+    return opponents > 0 ? total / opponents : (double)SimPositionValue(evaluator, s, player);
+}
+
+/**
+ * @brief Value of the best use of the remaining dice, front to back
+ */
+double QueueValue(const LudoState& s, int player, const int* dice, int numDice) {
+    if (numDice == 0 || SimAllFinished(s, player)) return ReplyValue(s, player);
+    LudoMove moves[RULES_MAX_TOKENS];
+    int count = GenerateMoves<GameRules>(s, player, dice, 1, moves, RULES_MAX_TOKENS);
+    if (count == 0) return QueueValue(s, player, dice + 1, numDice - 1);
+    double best = 0.0;
+    for (int i = 0; i < count; i++) {
+        LudoState next = s;
+        ApplyMove<GameRules>(next, player, moves[i]);
+        double v = QueueValue(next, player, dice + 1, numDice - 1);
+        if (v > best) best = v;
+    }
+    return best;
+}
+
+/**
+ * @brief Checks if a token on the track could be hit by an opponent rolling one die
+ */
+bool Exposed(const LudoState& s, int player, int pos) {
+    const BoardGeometry& g = Board(s.board);
+    if (pos == POS_YARD || pos >= g.homeFirst) return false;
+    int cell = g.cell[player][pos];
+    if (IsSafeCell<GameRules>(g, cell)) return false;
+    for (int d = 1; d <= 6; d++) {
+        if (s.cells[(cell - d + g.trackLength) % g.trackLength] & ~(1 << player)) return true;
+    }
+    return false;
+}
+
+bool OnSafeSquare(const LudoState& s, int player, int pos) {
+    const BoardGeometry& g = Board(s.board);
+    return pos != POS_YARD && pos < g.homeFirst && IsSafeCell<GameRules>(g, g.cell[player][pos]);
+}
+
+Analysis Analyze(const Position& p) {
+    Analysis a = {};
+    LudoMove moves[RULES_MAX_TOKENS];
+    a.candidates = GenerateMoves<GameRules>(p.before, p.player, p.dice, 1, moves, RULES_MAX_TOKENS);
+    // A die with no legal move was skipped; there is nothing to judge
+    if (a.candidates == 0) return a;
+
+    int played = 0, best = 0;
+    double values[RULES_MAX_TOKENS] = {};
+    LudoState after[RULES_MAX_TOKENS];
+    for (int i = 0; i < a.candidates; i++) {
+        after[i] = p.before;
+        ApplyMove<GameRules>(after[i], p.player, moves[i]);
+        // A forced move needs no search
+        values[i] = a.candidates == 1 ? 0.0 : QueueValue(after[i], p.player, p.dice + 1, p.numDice - 1);
+        if (moves[i].token == p.played) played = i;
+        if (values[i] > values[best]) best = i;
+    }
+    a.best = moves[best].token;
+    a.playedValue = (float)values[played];
+    a.bestValue = (float)values[best];
+    if (best == played) return a;
+
+    const LudoMove& m = moves[played];
+    bool exposed = Exposed(after[played], p.player, m.to);
+    if (exposed && OnSafeSquare(p.before, p.player, m.from)) a.tags |= TAG_LEFT_SAFE;
+    else if (exposed && !Exposed(after[best], p.player, moves[best].to)) a.tags |= TAG_EXPOSED;
+    if ((moves[best].flags & MOVE_CAPTURE) && !(m.flags & MOVE_CAPTURE)) a.tags |= TAG_MISSED_CAPTURE;
+    if ((moves[best].flags & MOVE_FINISH) && !(m.flags & MOVE_FINISH)) a.tags |= TAG_MISSED_FINISH;
+    return a;
+}
+
+/** @brief Readable reasons for a reported move */
+std::string TagText(int tags) {
+    static const char* const TEXT[] = {
+        "left a safe square exposed", "left a token exposed", "missed a capture", "missed finishing a token"
+    };
+    std::string text;
+    for (int k = 0; k < 4; k++) {
+        if (!(tags & (1 << k))) continue;
+        if (!text.empty()) text += ", ";
+        text += TEXT[k];
+    }
+    return text;
+}
+
+/**
+ * @brief Rebuilds the position before every move of a record
+ * @return false if an event is not legal where it was played
+ */
+bool Rebuild(const MatchRecord& record, std::vector<Position>& out) {
+    LudoState s = record.start;
+    const std::vector<ReplayEvent>& ev = record.events;
+    int turn = 0;
+    for (size_t i = 0; i < ev.size(); i++) {
+        if (record.StartsTurn((int)i)) turn++;
+
+        if (ev[i].token != REPLAY_NO_MOVE) {
+            Position p = {};
+            p.before = s;
+            p.event = (int)i;
+            p.turn = turn;
+            p.player = ev[i].player;
+            p.played = ev[i].token;
+            // The rest of the queue is the dice this seat uses next
+            for (size_t k = i; k < ev.size() && p.numDice < ev[i].queued && p.numDice < RULES_MAX_DICE; k++) {
+                if (ev[k].player != ev[i].player) break;
+                p.dice[p.numDice++] = ev[k].die;
+            }
+            out.push_back(p);
+        }
+        if (!ApplyReplayEvent(s, ev[i])) {
+            fprintf(stderr, "Event %zu (seat %d, die %d, token %d) is not legal in its position\n",
+                    i, ev[i].player, ev[i].die, ev[i].token);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <replay file> [--weights FILE] [--threads N] [--inaccuracy X] [--blunder X] "
+                        "[--csv FILE]\n", argv[0]);
+        return 1;
+    }
+    const char* replayPath = argv[1];
+    const char* weightsPath = "assets/evaluator.bin";
+    const char* csvPath = nullptr;
+    int threads = (int)std::thread::hardware_concurrency();
+    float inaccuracy = 0.02f;
+    float blunder = 0.05f;
+
+    for (int i = 2; i < argc; i += 2) {
+        if (i + 1 == argc) {
+            fprintf(stderr, "Missing value for %s\n", argv[i]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--weights") == 0) weightsPath = argv[i + 1];
+        else if (strcmp(argv[i], "--threads") == 0) threads = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--inaccuracy") == 0) inaccuracy = (float)atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--blunder") == 0) blunder = (float)atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--csv") == 0) csvPath = argv[i + 1];
+        else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (threads < 1) threads = 1;
+
+    MatchRecord record;
+    if (!record.Load(replayPath)) {
+        fprintf(stderr, "Cannot read replay %s\n", replayPath);
+        return 1;
+    }
+    if (!evaluator.Load(weightsPath)) {
+        fprintf(stderr, "Cannot read evaluator weights from %s\n", weightsPath);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Position> positions;
+    if (!Rebuild(record, positions)) return 1;
+
+    // Positions are handed out one at a time; long searches do not hold up the rest
+    std::vector<Analysis> results(positions.size());
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&]() {
+            for (size_t i = next++; i < positions.size(); i = next++) results[i] = Analyze(positions[i]);
+        });
+    }
+    for (std::thread& worker : pool) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    FILE* csv = nullptr;
+    if (csvPath != nullptr) {
+        csv = strcmp(csvPath, "-") == 0 ? stdout : fopen(csvPath, "w");
+        if (csv == nullptr) {
+            fprintf(stderr, "Cannot write %s\n", csvPath);
+            return 1;
+        }
+        fprintf(csv, "event,turn,seat,dice,candidates,played,best,played_value,best_value,loss,tags\n");
+    }
+
+    int seats = record.start.numPlayers;
+    std::vector<int> choices(seats, 0), inaccuracies(seats, 0), blunders(seats, 0);
+    std::vector<double> totalLoss(seats, 0.0);
+    printf("%s: %zu dice, %zu moves analysed in %.1f ms (%d threads)\n\n",
+           replayPath, record.events.size(), positions.size(), seconds * 1000.0, threads);
+    printf(" turn  seat  dice   played  best   loss\n");
+    for (size_t i = 0; i < positions.size(); i++) {
+        const Position& p = positions[i];
+        const Analysis& a = results[i];
+        float loss = a.bestValue - a.playedValue;
+        char dice[8] = {};
+        for (int k = 0; k < p.numDice; k++) dice[k] = (char)('0' + p.dice[k]);
+
+        if (csv != nullptr) {
+            fprintf(csv, "%d,%d,%d,%s,%d,%d,%d,%.4f,%.4f,%.4f,%d\n", p.event, p.turn, p.player, dice,
+                    a.candidates, p.played, a.best, a.playedValue, a.bestValue, loss, a.tags);
+        }
+        if (a.candidates < 2) continue;
+        choices[p.player]++;
+        totalLoss[p.player] += loss;
+
+        // Leaving a safe square into reach of an opponent is pointed out at half the loss
+        bool reported = loss >= inaccuracy || ((a.tags & TAG_LEFT_SAFE) && loss >= inaccuracy / 2);
+        if (!reported) continue;
+        bool isBlunder = loss >= blunder;
+        if (isBlunder) blunders[p.player]++;
+        else inaccuracies[p.player]++;
+        printf("%5d  %4d  %-5s  %6d  %4d  %5.3f  %s%s%s\n", p.turn, p.player, dice, p.played, a.best, loss,
+               isBlunder ? "blunder" : "inaccuracy", a.tags ? ": " : "", TagText(a.tags).c_str());
+    }
+    if (csv != nullptr && csv != stdout) fclose(csv);
+
+    printf("\n seat  choices  mean loss  inaccuracies  blunders\n");
+    for (int q = 0; q < seats; q++) {
+        printf("%5d  %7d  %9.4f  %12d  %8d\n", q, choices[q],
+               choices[q] > 0 ? totalLoss[q] / choices[q] : 0.0, inaccuracies[q], blunders[q]);
+    }
+    return 0;
+}
@@ -0,0 +1,292 @@
+/**
+ * @file ludo_shutdown.cpp
+ * @brief Measures how long the scheduler thread takes to stop under bot load
+ *
+ * Runs the game's SchedulerThread with one bot coroutine per seat of the
+ * classic board, each playing its whole turn with the in-game bot whenever
+ * the tick wakes it, while background threads simulate games on every core.
+ * After a random stretch of play a stop is requested and the join is timed.
+ *
+ * Every trial is run twice: once with the game mutex free, and once with
+ * another thread taking the mutex just before the stop and holding it past
+ * the deadline. Both must join within SchedulerThread::SHUTDOWN_DEADLINE_MS;
+ * the tool exits with status 1 if any trial does not.
+ *
+ * A last trial covers teardown after a missed deadline, in the order main.cpp
+ * uses: a tick is stalled on the dice mutex past the deadline, so Stop gives
+ * up, and the scope owning the thread is then left before the mutexes are
+ * destroyed. The thread must be joined by then, and no tick may run after.
+ *
+ * Usage: ludo_shutdown [options]
+ *   --trials N       Stops timed per mode (default 20)
+ *   --tick-rate N    Logic ticks per second (default 1000)
+ *   --load N         Background simulation threads (default: all cores)
+ *   --seed N         Seed for dice and stop times (default 1)
+ */
+
+#include "../include/Bot.h"
+#include "../include/SchedulerThread.h"
+#include "../include/Simulator.h"
+#include "../include/Tablebase.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/** @brief The game mutex every tick holds; initialized and destroyed as in main.cpp */
+pthread_mutex_t mutex;
+
+/** @brief Stands in for the dice mutex a player's turn takes inside a tick */
+pthread_mutex_t mutexDice;
+
+namespace {
+
+/**
+ * @brief Match the bot seats play; only touched by ticks, under the game mutex
+ */
+struct BotMatch {
+    LudoState state;
+    int seatToMove;     ///< 0-based seat the next tick wakes
+    SimRng rng;
+    long turns;         ///< Turns played over every trial
+
+    BotMatch() : seatToMove(0), rng(1), turns(0) { InitState(state, CLASSIC_TOKENS, 0); }
+};
+
+BotMatch match;
+
+std::atomic<bool> stallTicks(false);        ///< The next tick blocks on mutexDice
+std::atomic<bool> stalled(false);           ///< A tick is waiting for mutexDice
+std::atomic<bool> mutexesDestroyed(false);  ///< Set just before the mutexes are destroyed
+std::atomic<int> lateTicks(0);              ///< Ticks that ran after that
+
+/**
+ * @brief Plays a seat's turn with the in-game bot, as a bot seat of the game does
+ */
+void PlayTurn(int seat) {
+    int dice[RULES_MAX_DICE];
+    int numDice = 0;
+    do {
+        dice[numDice++] = match.rng.Die();
+    } while (dice[numDice - 1] == 6 && numDice < RULES_MAX_DICE);
+
+    for (int k = 0; k < numDice; k++) {
+        LudoMove m;
+        if (BotChooseMove(match.state, seat, dice + k, numDice - k, PHASE_FIRST, m)) {
+            ApplyMove<GameRules>(match.state, seat, m);
+        }
+    }
+    match.turns++;
+
+    // Start over once someone has brought every token home
+    int finished = Board(match.state.board).finished;
+    bool won = true;
+    for (int t = 0; t < match.state.numTokens; t++) won = won && match.state.pos[seat][t] == finished;
+    if (won) InitState(match.state, CLASSIC_TOKENS, 0);
+}
+
+/**
+ * @brief Turn loop of one bot seat
+ */
+TurnTask BotSeat(TurnScheduler& scheduler, int seat) {
+    while (!scheduler.StopRequested()) {
+        co_await scheduler.WaitForTurn(seat);
+        if (scheduler.StopRequested()) break;
+        PlayTurn(seat);
+        match.seatToMove = (seat + 1) % CLASSIC_PLAYERS;
+    }
+}
+
+/**
+ * @brief One logic tick: wakes the seat to move, like the game's tick
+ */
+void BotTick(void* args, const TickInput&) {
+    TurnScheduler* scheduler = (TurnScheduler*)args;
+    if (mutexesDestroyed) lateTicks++;
+    if (stallTicks.exchange(false)) {
+        // Like a player's dice roll: blocks however long the holder keeps it
+        stalled = true;
+        pthread_mutex_lock(&mutexDice);
+        pthread_mutex_unlock(&mutexDice);
+        if (mutexesDestroyed) lateTicks++;
+    }
+    scheduler->Wake(match.seatToMove);
+    scheduler->Tick();
+}
+
+/** @brief Shutdown latencies of one mode, in milliseconds */
+struct Latencies {
+    std::vector<double> ms;
+    int missed = 0;
+
+    void Report(const char* mode) const {
+        std::vector<double> sorted = ms;
+        std::sort(sorted.begin(), sorted.end());
+        double p50 = sorted.empty() ? 0.0 : sorted[sorted.size() / 2];
+        double max = sorted.empty() ? 0.0 : sorted.back();
+        printf("%-12s %3zu stops  p50 %7.2f ms  max %7.2f ms  missed %d\n", mode, ms.size(), p50, max, missed);
+    }
+};
+
+/**
+ * @brief Plays for a while, then stops the thread and times the join
+ * @param holdMutex Take the game mutex on another thread just before the stop
+ */
+void Trial(TurnScheduler& scheduler, SchedulerThread& thread, int runMs, bool holdMutex, Latencies& out) {
+    for (int seat = 0; seat < CLASSIC_PLAYERS; seat++) {
+        scheduler.Spawn(BotSeat(scheduler, seat));
+    }
+    if (!thread.Start()) {
+        fprintf(stderr, "Cannot start the scheduler thread\n");
+        exit(1);
+    }
+    usleep(runMs * 1000);
+
+    // The holder keeps the mutex well past the deadline, so only a bounded lock wait can meet it
+    std::atomic<bool> held(false);
+    std::thread holder;
+    if (holdMutex) {
+        holder = std::thread([&held] {
+            pthread_mutex_lock(&mutex);
+            held = true;
+            usleep((SchedulerThread::SHUTDOWN_DEADLINE_MS + SchedulerThread::STOP_POLL_MS) * 1000);
+            pthread_mutex_unlock(&mutex);
+        });
+        while (!held) std::this_thread::yield();
+    }
+
+    double ms = 0.0;
+    bool joined = thread.Stop(&ms);
+    if (!joined || ms > SchedulerThread::SHUTDOWN_DEADLINE_MS) out.missed++;
+    out.ms.push_back(ms);
+
+    if (!joined) thread.Join();
+    if (holder.joinable()) holder.join();
+    scheduler.Clear();
+}
+
+/** @brief Owns the thread like Game does: the thread is declared, and so joined, after the scheduler */
+struct Session {
+    TurnScheduler scheduler;
+    SchedulerThread thread;
+
+    Session() : thread(scheduler, &mutex, &BotTick, &scheduler) {}
+};
+
+/**
+ * @brief Misses the deadline on purpose, then tears down as main.cpp does
+ * @return true if the thread was joined before the mutexes were destroyed
+ */
+bool TeardownTrial(int tickRate, int runMs) {
+    pthread_mutex_init(&mutex, NULL);
+    pthread_mutex_init(&mutexDice, NULL);
+
+    // Holds the dice mutex for two deadlines, so the stalled tick outlives Stop
+    std::atomic<bool> held(false);
+    std::thread holder;
+    bool joinedInTime = true;
+    bool stillRunning = false;
+    {
+        Session session;
+        session.thread.tickRate = tickRate;
+        for (int seat = 0; seat < CLASSIC_PLAYERS; seat++) {
+            session.scheduler.Spawn(BotSeat(session.scheduler, seat));
+        }
+        if (!session.thread.Start()) {
+            fprintf(stderr, "Cannot start the scheduler thread\n");
+            exit(1);
+        }
+        usleep(runMs * 1000);
+
+        holder = std::thread([&held] {
+            pthread_mutex_lock(&mutexDice);
+            held = true;
+            usleep(2 * SchedulerThread::SHUTDOWN_DEADLINE_MS * 1000);
+            pthread_mutex_unlock(&mutexDice);
+        });
+        while (!held) std::this_thread::yield();
+        stallTicks = true;
+        while (!stalled) std::this_thread::yield();
+
+        joinedInTime = session.thread.Stop();
+        stillRunning = session.thread.Running();
+        // Leaving the scope joins the thread, as ~Game does
+    }
+    mutexesDestroyed = true;
+    pthread_mutex_destroy(&mutex);
+    pthread_mutex_destroy(&mutexDice);
+    holder.join();
+
+    printf("teardown     stop %s the deadline, thread %s after it, %d ticks after the mutexes were destroyed\n",
+           joinedInTime ? "met" : "missed", stillRunning ? "joinable" : "gone", lateTicks.load());
+    if (joinedInTime) fprintf(stderr, "The stalled tick did not make Stop miss its deadline\n");
+    return !joinedInTime && stillRunning && lateTicks == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int trials = 20;
+    int tickRate = 1000;
+    int load = (int)std::thread::hardware_concurrency();
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 == argc) {
+            fprintf(stderr, "Missing value for %s\n", argv[i]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--trials") == 0) trials = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--tick-rate") == 0) tickRate = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--load") == 0) load = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0) seed = strtoull(argv[i + 1], NULL, 10);
+        else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (trials < 1) trials = 1;
+    if (load < 0) load = 0;
+    match.rng = SimRng(seed);
+
+    // Background simulations keep every core busy while the thread is stopped
+    std::atomic<bool> done(false);
+    std::vector<std::thread> background;
+    for (int w = 0; w < load; w++) {
+        background.emplace_back([&done, seed, w] {
+            const SimPolicy policies[CLASSIC_PLAYERS] = { SimBotPolicy, SimBotPolicy, SimBotPolicy, SimBotPolicy };
+            for (uint64_t game = 0; !done; game++) {
+                SimRng rng(SimGameSeed(seed + 1 + w, game));
+                SimulateGame<GameRules>(CLASSIC_TOKENS, policies, rng, nullptr);
+            }
+        });
+    }
+
+    SimRng stops(seed ^ 0x5DEECE66DULL);
+    Latencies unlocked, locked;
+    pthread_mutex_init(&mutex, NULL);
+    pthread_mutex_init(&mutexDice, NULL);
+    {
+        Session session;
+        session.thread.tickRate = tickRate;
+        for (int t = 0; t < trials; t++) {
+            Trial(session.scheduler, session.thread, 20 + stops.Below(100), false, unlocked);
+            Trial(session.scheduler, session.thread, 20 + stops.Below(100), true, locked);
+        }
+    }
+    pthread_mutex_destroy(&mutex);
+    pthread_mutex_destroy(&mutexDice);
+    bool tornDown = TeardownTrial(tickRate, 20 + stops.Below(100));
+    done = true;
+    for (std::thread& b : background) b.join();
+
+    printf("%d bot turns at %d ticks/s with %d loaded cores; deadline %d ms\n",
+           (int)match.turns, tickRate, load, SchedulerThread::SHUTDOWN_DEADLINE_MS);
+    unlocked.Report("mutex free");
+    locked.Report("mutex held");
+    return unlocked.missed + locked.missed > 0 || !tornDown ? 1 : 0;
+}
@@ -0,0 +1,214 @@
+/**
+ * @file ludo_sim.cpp
+ * @brief Headless batch simulator with streaming statistics
+ *
+ * Plays many games on the rules engine across worker threads. Each thread
+ * owns its generator and its SimStats, so the hot loop shares nothing;
+ * the per-thread aggregates are merged after the threads are joined and
+ * written as JSON or CSV. Memory does not depend on the number of games.
+ *
+ * Usage: ludo_sim <games> [options]
+ *   --tokens N      Tokens per player (1-8, default 4)
+ *   --threads N     Worker threads (default: all cores)
+ *   --seed N        Base seed (default 1)
+ *   --policy NAME   bot, greedy or random for every seat (default bot)
+ *   --rules NAME    Rule variant: classic, quick or cutthroat (default classic)
+ *   --board ARMS    Built-in board with 4, 6 or 8 arms, or a board description file
+ *   --batch         Run classic greedy games on the SIMD lockstep engine
+ *   --json FILE     Write aggregates as JSON ("-" for stdout)
+ *   --csv FILE      Write aggregates as CSV ("-" for stdout)
+ */
+
+#include "../include/BatchSim.h"
+#include "../include/Simulator.h"
+#include "../include/Stats.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef SimResult (*SimGameFn)(int tokens, const SimPolicy* policies, SimRng& rng, SimStats* stats, int board,
+                               SimRng* policyRngs);
+
+/** @brief Specialized engine entry points of one rule variant */
+struct RuleVariant {
+    const char* name;
+    SimGameFn game;
+    SimPolicy greedy;
+    SimPolicy random;
+};
+
+#define VARIANT_ENTRY(R) { R::NAME, SimulateGame<R>, SimGreedyPolicy<R>, SimRandomPolicy<R> },
+const RuleVariant VARIANTS[] = { RULE_VARIANTS(VARIANT_ENTRY) };
+#undef VARIANT_ENTRY
+
+const RuleVariant* FindVariant(const char* name) {
+    for (const RuleVariant& v : VARIANTS) {
+        if (strcmp(name, v.name) == 0) return &v;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Resolves --board: a built-in arm count or a description file
+ * @return Registry id, or -1 on error
+ */
+int FindBoard(const char* arg) {
+    char* end;
+    long arms = strtol(arg, &end, 10);
+    if (*end == '\0') {
+        int id = StandardBoard((int)arms);
+        if (id < 0) fprintf(stderr, "No built-in board with %s arms\n", arg);
+        return id;
+    }
+    BoardGeometry g;
+    if (!LoadBoardGeometry(arg, g)) return -1;
+    return RegisterBoard(g);
+}
+
+bool WriteReport(const SimStats& stats, const char* path, bool json) {
+    FILE* f = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (f == NULL) {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return false;
+    }
+    if (json) stats.WriteJson(f);
+    else stats.WriteCsv(f);
+    if (f != stdout) fclose(f);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <games> [--tokens N] [--threads N] [--seed N] [--policy bot|greedy|random] "
+                        "[--rules classic|quick|cutthroat] [--board 4|6|8|FILE] [--batch] [--json FILE] [--csv FILE]\n", argv[0]);
+        return 1;
+    }
+    long long games = atoll(argv[1]);
+    int tokens = CLASSIC_TOKENS;
+    int threads = (int)std::thread::hardware_concurrency();
+    unsigned long long seed = 1;
+    const char* policyName = "bot";
+    const RuleVariant* rules = FindVariant(ClassicRules::NAME);
+    int board = BOARD_CLASSIC;
+    const char* jsonPath = nullptr;
+    const char* csvPath = nullptr;
+    bool batch = false;
+
+    for (int i = 2; i < argc; i += 2) {
+        if (strcmp(argv[i], "--batch") == 0) {
+            batch = true;
+            i--;
+            continue;
+        }
+        if (i + 1 == argc) {
+            fprintf(stderr, "Missing value for %s\n", argv[i]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--tokens") == 0) tokens = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--threads") == 0) threads = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0) seed = strtoull(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--policy") == 0) policyName = argv[i + 1];
+        else if (strcmp(argv[i], "--rules") == 0) {
+            rules = FindVariant(argv[i + 1]);
+            if (rules == nullptr) {
+                fprintf(stderr, "Unknown rules %s\n", argv[i + 1]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--board") == 0) {
+            board = FindBoard(argv[i + 1]);
+            if (board < 0) return 1;
+        }
+        else if (strcmp(argv[i], "--json") == 0) jsonPath = argv[i + 1];
+        else if (strcmp(argv[i], "--csv") == 0) csvPath = argv[i + 1];
+        else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (games < 1 || tokens < 1 || tokens > RULES_MAX_TOKENS) {
+        fprintf(stderr, "Need at least one game and 1-%d tokens\n", RULES_MAX_TOKENS);
+        return 1;
+    }
+    if (threads < 1) threads = 1;
+
+    SimPolicy policy;
+    if (strcmp(policyName, "random") == 0) policy = rules->random;
+    else if (strcmp(policyName, "greedy") == 0) policy = rules->greedy;
+    else if (strcmp(policyName, "bot") == 0) policy = SimBotPolicy;
+    else {
+        fprintf(stderr, "Unknown policy %s\n", policyName);
+        return 1;
+    }
+    if (policy == SimBotPolicy && rules != FindVariant(GameRules::NAME)) {
+        fprintf(stderr, "The bot plays the %s rules; use --policy greedy or random\n", GameRules::NAME);
+        return 1;
+    }
+    if (batch && (policy != rules->greedy || rules != FindVariant(ClassicRules::NAME) || board != BOARD_CLASSIC)) {
+        fprintf(stderr, "The batch engine plays the greedy policy on the classic rules and board; use --policy greedy\n");
+        return 1;
+    }
+    if (batch && tokens > CLASSIC_TOKENS) {
+        fprintf(stderr, "The batch engine plays at most %d tokens per player\n", CLASSIC_TOKENS);
+        return 1;
+    }
+
+    SimPolicy policies[RULES_MAX_PLAYERS];
+    for (int p = 0; p < RULES_MAX_PLAYERS; p++) policies[p] = policy;
+
+    // One aggregate per thread; each is only touched by its owner until the join
+    // The bucket width grows with the board, as SimulateGame's turn limit does, so long games are not lumped together
+    int lengthBucket = SimLengthBucket(board, tokens);
+    std::vector<std::unique_ptr<SimStats>> perThread;
+    for (int t = 0; t < threads; t++) perThread.emplace_back(new SimStats(lengthBucket));
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    SimGameFn game = rules->game;
+    for (int t = 0; t < threads; t++) {
+        long long first = games * t / threads;
+        long long last = games * (t + 1) / threads;
+        SimStats* stats = perThread[t].get();
+        pool.emplace_back([=, &policies]() {
+            if (batch) {
+                BatchSimulator sim(tokens, seed, stats);
+                sim.Run(first, last);
+                return;
+            }
+            for (long long g = first; g < last; g++) {
+                SimRng rng(SimGameSeed(seed, (uint64_t)g));
+                game(tokens, policies, rng, stats, board, nullptr);
+            }
+        });
+    }
+    for (std::thread& worker : pool) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    SimStats total(lengthBucket);
+    for (const auto& stats : perThread) total.Merge(*stats);
+
+    fprintf(stderr, "%lld games in %.2fs (%.0f games/s, %.0f games/s per core, %d threads, %s, %s rules, %d arms)\n",
+            games, seconds, games / seconds, games / seconds / threads, threads,
+            batch ? BatchKernelName() : "scalar engine", rules->name, Board(board).arms);
+    // Rates over finished games, as in the JSON report
+    double finished = total.games.value > 0 ? (double)total.games.value : 1.0;
+    if (total.unfinished.value > 0) {
+        fprintf(stderr, "%llu games hit the turn limit and are left out\n", (unsigned long long)total.unfinished.value);
+    }
+    fprintf(stderr, "Seat win rates:");
+    for (int p = 0; p < total.players; p++) fprintf(stderr, " %.4f", total.seatWins[p].value / finished);
+    fprintf(stderr, ", median length %.0f turns\n", total.gameLengthSketch.Quantile(0.5));
+
+    bool ok = true;
+    if (jsonPath) ok = WriteReport(total, jsonPath, true) && ok;
+    if (csvPath) ok = WriteReport(total, csvPath, false) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+/**
+ * @file ludo_tablebase.cpp
+ * @brief Offline generator for the two-player endgame tablebase
+ *
+ * Solves every position with two players left and 1 or 2 tokens each by
+ * iterating the turn equation until the values stop changing: the side to
+ * move picks the best sequence of choices for every dice outcome, and the
+ * result is weighted by the outcome probabilities. Captures send tokens
+ * back to the yard, so the position graph has cycles and the values are
+ * found by repeated sweeps rather than a single backward pass. Sweeps are
+ * split across threads and update the shared array in place.
+ *
+ * Usage: ludo_tablebase <tokens> <output file> [threads]
+ */
+
+#include "../include/Rules.h"
+#include "../include/Tablebase.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const double EPSILON = 1e-6;        // Convergence threshold, well below the 1/65535 quantization
+const int MAX_SWEEPS = 20000;       // Safety stop for slowly converging tables
+const int OFFSETS = 3;              // Opponent is 1, 2 or 3 seats away
+const int PHASES = 2;
+
+/**
+ * @brief Working state of the generator
+ */
+struct Solver {
+    int tokens;
+    int configs;
+    std::vector<uint8_t> configPos;     // Decoded positions per configuration
+    std::vector<uint8_t> configHome;    // Home flag per configuration
+    std::vector<uint8_t> configDone;    // All tokens finished
+    std::vector<float> values;          // Win probability of the side to move
+
+    float Get(uint64_t i) const {
+        return std::atomic_ref<const float>(values[i]).load(std::memory_order_relaxed);
+    }
+
+    void Set(uint64_t i, float v) {
+        std::atomic_ref<float>(values[i]).store(v, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Builds the canonical state: side to move on seat 0, opponent on seat offset
+     */
+    void BuildState(LudoState& s, int offset, int mover, int opponent) const {
+        InitState(s, tokens, 0);
+        for (int p = 0; p < CLASSIC_PLAYERS; p++) {
+            for (int t = 0; t < tokens; t++) s.pos[p][t] = POS_FINISHED;
+        }
+        for (int t = 0; t < tokens; t++) {
+            s.pos[0][t] = configPos[mover * tokens + t];
+            s.pos[offset][t] = configPos[opponent * tokens + t];
+        }
+        if (configHome[mover]) s.homeMask |= 1;
+        if (configHome[opponent]) s.homeMask |= (uint8_t)(1 << offset);
+        IndexCells(s);
+    }
+
+    /**
+     * @brief Recomputes one entry from the current values of its successors
+     */
+    double Evaluate(int offset, int phase, int mover, int opponent) const {
+        LudoState s;
+        BuildState(s, offset, mover, opponent);
+
+        auto value = [this](int o, int ph, int m, int op) {
+            return (double)Get(EndgameEntryIndex(configs, o, ph, m, op));
+        };
+        auto leaf = [&](const LudoState& after) {
+            int a = EndgameConfigIndex(after.pos[0], tokens, after.homeMask & 1);
+            if (configDone[a]) return 1.0;
+            int b = EndgameConfigIndex(after.pos[offset], tokens, after.homeMask & (1 << offset));
+            return EndgameContinuation(value, a, b, offset, phase);
+        };
+
+        double total = 0.0;
+        for (int d = 0; d < TURN_DICE_COUNT; d++) {
+            const TurnDice& turnDice = TURN_DICE[d];
+            total += turnDice.prob * BestTurnValue(s, 0, turnDice.dice, turnDice.count, leaf);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Sweeps a range of entries once
+     * @return Largest change in the range
+     */
+    double Sweep(uint64_t begin, uint64_t end) {
+        double maxDelta = 0.0;
+        uint64_t perBlock = (uint64_t)configs * configs;
+        for (uint64_t i = begin; i < end; i++) {
+            int block = (int)(i / perBlock);
+            int mover = (int)((i % perBlock) / configs);
+            int opponent = (int)(i % configs);
+            if (configDone[mover] || configDone[opponent]) continue;
+
+            double v = Evaluate(block / PHASES + 1, block % PHASES, mover, opponent);
+            double delta = std::fabs(v - Get(i));
+            if (delta > maxDelta) maxDelta = delta;
+            Set(i, (float)v);
+        }
+        return maxDelta;
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <tokens 1-%d> <output file> [threads]\n", argv[0], TABLEBASE_MAX_TOKENS);
+        return 1;
+    }
+    int tokens = atoi(argv[1]);
+    if (tokens < 1 || tokens > TABLEBASE_MAX_TOKENS) {
+        fprintf(stderr, "Token count must be between 1 and %d\n", TABLEBASE_MAX_TOKENS);
+        return 1;
+    }
+    int threads = argc > 3 ? atoi(argv[3]) : (int)std::thread::hardware_concurrency();
+    if (threads < 1) threads = 1;
+
+    Solver solver;
+    solver.tokens = tokens;
+    solver.configs = EndgameConfigCount(tokens);
+    solver.configPos.resize((size_t)solver.configs * tokens);
+    solver.configHome.resize(solver.configs);
+    solver.configDone.resize(solver.configs);
+    for (int c = 0; c < solver.configs; c++) {
+        bool home;
+        EndgameConfigDecode(c, tokens, &solver.configPos[(size_t)c * tokens], home);
+        solver.configHome[c] = home;
+        bool done = true;
+        for (int t = 0; t < tokens; t++) {
+            if (solver.configPos[(size_t)c * tokens + t] != POS_FINISHED) done = false;
+        }
+        solver.configDone[c] = done;
+    }
+
+    // Terminal entries: the side to move has already finished (1) or its opponent has (0)
+    uint64_t entries = (uint64_t)OFFSETS * PHASES * solver.configs * solver.configs;
+    solver.values.assign(entries, 0.5f);
+    for (uint64_t i = 0; i < entries; i++) {
+        int mover = (int)((i / solver.configs) % solver.configs);
+        int opponent = (int)(i % solver.configs);
+        if (solver.configDone[mover]) solver.values[i] = 1.0f;
+        else if (solver.configDone[opponent]) solver.values[i] = 0.0f;
+    }
+    printf("Solving %d-token endgames: %d configurations, %llu entries, %d threads\n",
+           tokens, solver.configs, (unsigned long long)entries, threads);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<double> deltas(threads);
+    int sweep = 0;
+    double maxDelta = 1.0;
+    while (maxDelta > EPSILON && sweep < MAX_SWEEPS) {
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; t++) {
+            uint64_t begin = entries * t / threads;
+            uint64_t end = entries * (t + 1) / threads;
+            pool.emplace_back([&solver, &deltas, t, begin, end]() { deltas[t] = solver.Sweep(begin, end); });
+        }
+        maxDelta = 0.0;
+        for (int t = 0; t < threads; t++) {
+            pool[t].join();
+            if (deltas[t] > maxDelta) maxDelta = deltas[t];
+        }
+        sweep++;
+        if (sweep % 10 == 0) printf("  sweep %d: max change %.3g\n", sweep, maxDelta);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Converged after %d sweeps in %.1fs (max change %.3g)\n", sweep, seconds, maxDelta);
+
+    // Quantize to 16 bits; the array is mapped as-is by the game
+    TablebaseHeader header = {};
+    header.magic = TABLEBASE_MAGIC;
+    header.version = TABLEBASE_VERSION;
+    header.numTokens = (uint8_t)tokens;
+    header.configCount = (uint32_t)solver.configs;
+    header.dataOffset = 64;
+    header.entryCount = entries;
+
+    std::vector<uint16_t> quantized(entries);
+    for (uint64_t i = 0; i < entries; i++) {
+        double v = solver.values[i] < 0.0f ? 0.0 : (solver.values[i] > 1.0f ? 1.0 : solver.values[i]);
+        quantized[i] = (uint16_t)std::lround(v * TABLEBASE_SCALE);
+    }
+
+    FILE* f = fopen(argv[2], "wb");
+    if (f == NULL) {
+        fprintf(stderr, "Cannot write %s\n", argv[2]);
+        return 1;
+    }
+    uint8_t padded[64] = {};
+    memcpy(padded, &header, sizeof(header));
+    bool ok = fwrite(padded, 1, sizeof(padded), f) == sizeof(padded) &&
+              fwrite(quantized.data(), sizeof(uint16_t), entries, f) == entries;
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "Failed writing %s\n", argv[2]);
+        return 1;
+    }
+    printf("Wrote %s (%llu bytes)\n", argv[2], (unsigned long long)(64 + entries * sizeof(uint16_t)));
+    return 0;
+}
@@ -0,0 +1,451 @@
+/**
+ * @file ludo_tournament.cpp
+ * @brief Round-robin tournament between bot policies with Elo ratings
+ *
+ * Every pair of policies meets on the classic board with two seats each,
+ * in all six ways of seating two A's and two B's. The six games of a deal
+ * share one seed for the dice and turn order, and every seat draws its
+ * policy's random choices (random, mcts) from a generator of its own, so
+ * both policies see the same dice from every seat whatever they decide and
+ * seat and luck effects mostly cancel. Deals are handed out to worker
+ * threads one at a time and every game is streamed to a CSV file as it
+ * finishes, so memory stays flat however long the run.
+ *
+ * Ratings are fitted to the pairwise win counts with the Bradley-Terry
+ * model, which Elo approximates incrementally, and reported on the Elo
+ * scale with 95% intervals from a parametric bootstrap of those counts.
+ *
+ * Usage: ludo_tournament <deals per pair> [options]
+ *   --policies LIST  Comma-separated: random, greedy, bot, eval, expecti, mcts
+ *                    (default random,greedy,bot,eval)
+ *   --weights FILE   Evaluator weights for eval, expecti and mcts
+ *                    (default assets/evaluator.bin)
+ *   --rollouts N     Rollouts per candidate move for mcts (default 32)
+ *   --depth N        Turns per mcts rollout before the evaluator scores it (default 4)
+ *   --tokens N       Tokens per player (1-8, default 4)
+ *   --threads N      Worker threads (default: all cores)
+ *   --seed N         Base seed (default 1)
+ *   --games FILE     Stream one CSV line per game here ("-" for stdout)
+ */
+
+#include "../include/Bot.h"
+#include "../include/Evaluator.h"
+#include "../include/Simulator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/** @brief Seats of the classic board; every policy gets two */
+const int SEATS = CLASSIC_PLAYERS;
+
+/** @brief The six seatings of two policies, 0 for A and 1 for B */
+const int SEATINGS[6][SEATS] = {
+    {0, 0, 1, 1}, {0, 1, 0, 1}, {0, 1, 1, 0}, {1, 0, 0, 1}, {1, 0, 1, 0}, {1, 1, 0, 0}
+};
+
+const int BOOTSTRAP_SAMPLES = 200;
+
+/** @brief Evaluator used by eval, expecti and mcts */
+Evaluator evaluator;
+
+int mctsRollouts = 32;
+int mctsDepth = 4;
+
+bool EvalPolicy(const LudoState& s, int player, const int* dice, int numDice,
+                int phase, SimRng& rng, LudoMove& out) {
+    (void)numDice;
+    (void)phase;
+    (void)rng;
+    return EvaluatorChooseMove(evaluator, s, player, dice, out);
+}
+
+/**
+ * @brief Expectiminimax to the end of the next opponent's turn
+ *
+ * Maximizes over the player's own remaining dice, then averages over
+ * which opponent moves next and every dice outcome of its turn, with the
+ * opponent replying greedily. Positions are scored by the evaluator.
+ */
+bool ExpectiPolicy(const LudoState& s, int player, const int* dice, int numDice,
+                   int phase, SimRng& rng, LudoMove& out) {
+    (void)phase;
+    (void)rng;
+    LudoMove moves[RULES_MAX_TOKENS];
+    int count = GenerateMoves<GameRules>(s, player, dice, 1, moves, RULES_MAX_TOKENS);
+    if (count == 0) return false;
+
+    auto reply = [player](const LudoState& after) {
+        if (SimAllFinished(after, player)) return 1.0;
+        double total = 0.0;
+        int opponents = 0;
+        for (int q = 0; q < after.numPlayers; q++) {
+            if (q == player || SimAllFinished(after, q)) continue;
+            opponents++;
+            for (int o = 0; o < TURN_DICE_COUNT; o++) {
+                LudoState next = after;
+                SimGreedyTurn(next, q, TURN_DICE[o].dice, TURN_DICE[o].count);
+                total += TURN_DICE[o].prob * SimPositionValue(evaluator, next, player);
+            }
+        }
+        return opponents > 0 ? total / opponents : (double)SimPositionValue(evaluator, after, player);
+    };
+
+    int best = 0;
+    double bestValue = -1.0;
+    for (int i = 0; i < count; i++) {
+        LudoState next = s;
+        ApplyMove<GameRules>(next, player, moves[i]);
+        double v = BestTurnValue<GameRules>(next, player, dice + 1, numDice - 1, reply);
+        if (v > bestValue) {
+            bestValue = v;
+            best = i;
+        }
+    }
+    out = moves[best];
+    return true;
+}
+
+/**
+ * @brief Plays greedy turns from a position for a few turns and scores where it ends
+ */
+double Rollout(LudoState s, int player, SimRng& rng) {
+    bool done[RULES_MAX_PLAYERS] = {};
+    int left = 0;
+    for (int p = 0; p < s.numPlayers; p++) {
+        done[p] = SimAllFinished(s, p);
+        if (!done[p]) left++;
+    }
+    if (done[player]) return 1.0;
+
+    SimTurnOrder order(s.numPlayers);
+    for (int turn = 0; turn < mctsDepth && left > 1; turn++) {
+        int seat = order.Next(rng, done);
+        int dice[RULES_MAX_DICE];
+        int numDice = 0;
+        while (true) {
+            int d = rng.Die();
+            if (d == 6 && numDice == RULES_MAX_DICE - 1) {
+                if (!GameRules::TRIPLE_SIX_FORFEITS) dice[numDice++] = d;
+                else numDice = 0;
+                break;
+            }
+            dice[numDice++] = d;
+            if (d != 6) break;
+        }
+        SimGreedyTurn(s, seat, dice, numDice);
+        if (SimAllFinished(s, seat)) {
+            if (seat == player) return 1.0 - (double)(s.numPlayers - left) / (s.numPlayers - 1);
+            done[seat] = true;
+            left--;
+        }
+    }
+    // Everyone else finished: the player came last
+    if (left <= 1) return 0.0;
+    return SimPositionValue(evaluator, s, player);
+}
+
+/**
+ * @brief Flat Monte Carlo search: the candidate with the best mean rollout
+ *
+ * Every candidate of the front die gets the same number of truncated
+ * greedy rollouts; the evaluator scores where a rollout stops. Rollout r
+ * rolls the same dice for every candidate, so candidates are compared on
+ * common luck rather than on rollout noise. Short rollouts play better
+ * than long ones: the gap between two candidates is a few hundredths of
+ * a finishing place, and a whole game of dice drowns it.
+ */
+bool MctsPolicy(const LudoState& s, int player, const int* dice, int numDice,
+                int phase, SimRng& rng, LudoMove& out) {
+    (void)numDice;
+    (void)phase;
+    LudoMove moves[RULES_MAX_TOKENS];
+    int count = GenerateMoves<GameRules>(s, player, dice, 1, moves, RULES_MAX_TOKENS);
+    if (count == 0) return false;
+    if (count == 1) {
+        out = moves[0];
+        return true;
+    }
+
+    uint64_t base = rng.Next();
+    int best = 0;
+    double bestValue = -1.0;
+    for (int i = 0; i < count; i++) {
+        LudoState next = s;
+        ApplyMove<GameRules>(next, player, moves[i]);
+        double total = 0.0;
+        for (int r = 0; r < mctsRollouts; r++) {
+            SimRng dice(SimGameSeed(base, (uint64_t)r));
+            total += Rollout(next, player, dice);
+        }
+        if (total > bestValue) {
+            bestValue = total;
+            best = i;
+        }
+    }
+    out = moves[best];
+    return true;
+}
+
+/** @brief A policy that can enter the tournament */
+struct PolicyEntry {
+    const char* name;
+    SimPolicy policy;
+    bool usesEvaluator;
+};
+
+const PolicyEntry POLICIES[] = {
+    { "random", SimRandomPolicy<GameRules>, false },
+    { "greedy", SimGreedyPolicy<GameRules>, false },
+    { "bot", SimBotPolicy, false },
+    { "eval", EvalPolicy, true },
+    { "expecti", ExpectiPolicy, true },
+    { "mcts", MctsPolicy, true },
+};
+
+const PolicyEntry* FindPolicy(const std::string& name) {
+    for (const PolicyEntry& p : POLICIES) {
+        if (name == p.name) return &p;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Fits Bradley-Terry strengths to pairwise win counts
+ * Half a win and half a loss are added to every pair that met, so a policy
+ * that never won still gets a finite rating
+ * @param wins wins[a * n + b] is the number of games a won against b
+ * @return Elo ratings centred on 1500
+ */
+std::vector<double> FitRatings(const std::vector<double>& wins, int n) {
+    std::vector<double> strength(n, 1.0), next(n);
+    for (int iter = 0; iter < 1000; iter++) {
+        for (int a = 0; a < n; a++) {
+            double won = 0.0, denom = 0.0;
+            for (int b = 0; b < n; b++) {
+                double games = wins[a * n + b] + wins[b * n + a];
+                if (a == b || games == 0.0) continue;
+                won += wins[a * n + b] + 0.5;
+                denom += (games + 1.0) / (strength[a] + strength[b]);
+            }
+            next[a] = denom > 0.0 ? won / denom : strength[a];
+        }
+        double logMean = 0.0;
+        for (int a = 0; a < n; a++) logMean += std::log(next[a]) / n;
+        for (int a = 0; a < n; a++) strength[a] = next[a] / std::exp(logMean);
+    }
+    std::vector<double> elo(n);
+    for (int a = 0; a < n; a++) elo[a] = 1500.0 + 400.0 * std::log10(strength[a]);
+    return elo;
+}
+
+/**
+ * @brief Binomial sample; the normal approximation once the variance is large
+ */
+double Binomial(SimRng& rng, long long n, double p) {
+    double variance = n * p * (1.0 - p);
+    if (variance > 25.0) {
+        // Box-Muller from two uniforms in (0, 1]
+        double u1 = (rng.Next() >> 11) * 0x1.0p-53 + 0x1.0p-54;
+        double u2 = (rng.Next() >> 11) * 0x1.0p-53;
+        double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+        double k = std::round(n * p + z * std::sqrt(variance));
+        return std::min(std::max(k, 0.0), (double)n);
+    }
+    long long k = 0;
+    for (long long i = 0; i < n; i++) {
+        if ((rng.Next() >> 11) * 0x1.0p-53 < p) k++;
+    }
+    return (double)k;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <deals per pair> [--policies LIST] [--weights FILE] [--rollouts N] [--depth N] "
+                        "[--tokens N] [--threads N] [--seed N] [--games FILE]\n", argv[0]);
+        return 1;
+    }
+    long long deals = atoll(argv[1]);
+    std::string policyList = "random,greedy,bot,eval";
+    const char* weightsPath = "assets/evaluator.bin";
+    const char* gamesPath = nullptr;
+    int tokens = CLASSIC_TOKENS;
+    int threads = (int)std::thread::hardware_concurrency();
+    unsigned long long seed = 1;
+
+    for (int i = 2; i < argc; i += 2) {
+        if (i + 1 == argc) {
+            fprintf(stderr, "Missing value for %s\n", argv[i]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--policies") == 0) policyList = argv[i + 1];
+        else if (strcmp(argv[i], "--weights") == 0) weightsPath = argv[i + 1];
+        else if (strcmp(argv[i], "--rollouts") == 0) mctsRollouts = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--depth") == 0) mctsDepth = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--tokens") == 0) tokens = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--threads") == 0) threads = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0) seed = strtoull(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--games") == 0) gamesPath = argv[i + 1];
+        else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (deals < 1 || tokens < 1 || tokens > RULES_MAX_TOKENS || mctsRollouts < 1 || mctsDepth < 1) {
+        fprintf(stderr, "Need at least one deal, 1-%d tokens and positive rollouts and depth\n", RULES_MAX_TOKENS);
+        return 1;
+    }
+    if (threads < 1) threads = 1;
+
+    std::vector<const PolicyEntry*> entrants;
+    bool needEvaluator = false;
+    for (size_t start = 0; start <= policyList.size();) {
+        size_t comma = policyList.find(',', start);
+        if (comma == std::string::npos) comma = policyList.size();
+        const PolicyEntry* p = FindPolicy(policyList.substr(start, comma - start));
+        if (p == nullptr) {
+            fprintf(stderr, "Unknown policy %s\n", policyList.substr(start, comma - start).c_str());
+            return 1;
+        }
+        entrants.push_back(p);
+        needEvaluator = needEvaluator || p->usesEvaluator;
+        start = comma + 1;
+    }
+    int n = (int)entrants.size();
+    if (n < 2) {
+        fprintf(stderr, "Need at least two policies\n");
+        return 1;
+    }
+    if (needEvaluator && !evaluator.Load(weightsPath)) {
+        fprintf(stderr, "Cannot read evaluator weights from %s\n", weightsPath);
+        return 1;
+    }
+
+    FILE* games = nullptr;
+    if (gamesPath != nullptr) {
+        games = strcmp(gamesPath, "-") == 0 ? stdout : fopen(gamesPath, "w");
+        if (games == nullptr) {
+            fprintf(stderr, "Cannot write %s\n", gamesPath);
+            return 1;
+        }
+        fprintf(games, "pair_a,pair_b,deal,seating,winner,turns,places\n");
+    }
+    std::mutex gamesMutex;
+
+    std::vector<std::pair<int, int>> pairs;
+    for (int a = 0; a < n; a++) {
+        for (int b = a + 1; b < n; b++) pairs.emplace_back(a, b);
+    }
+    long long jobs = (long long)pairs.size() * deals;
+
+    // Each thread counts into its own matrix; they are summed after the join
+    std::vector<std::vector<double>> perThread(threads, std::vector<double>(n * n, 0.0));
+    std::atomic<long long> next{0};
+    std::atomic<long long> unfinished{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t]() {
+            std::vector<double>& wins = perThread[t];
+            std::string lines;
+            for (long long job = next++; job < jobs; job = next++) {
+                int pair = (int)(job / deals);
+                long long deal = job % deals;
+                int ids[2] = { pairs[pair].first, pairs[pair].second };
+                uint64_t dealSeed = SimGameSeed(seed, (uint64_t)deal);
+
+                for (int k = 0; k < 6; k++) {
+                    SimPolicy policies[RULES_MAX_PLAYERS];
+                    for (int seat = 0; seat < SEATS; seat++) policies[seat] = entrants[ids[SEATINGS[k][seat]]]->policy;
+                    // Decisions never consume the dice; each seat's choices come from its own stream
+                    SimRng rng(dealSeed);
+                    SimRng decisions[SEATS] = {
+                        SimRng(SimGameSeed(dealSeed, 1)), SimRng(SimGameSeed(dealSeed, 2)),
+                        SimRng(SimGameSeed(dealSeed, 3)), SimRng(SimGameSeed(dealSeed, 4))
+                    };
+                    SimResult r = SimulateGame<GameRules>(tokens, policies, rng, nullptr, BOARD_CLASSIC, decisions);
+                    if (!r.finished) {
+                        unfinished++;
+                        continue;
+                    }
+                    int winner = ids[SEATINGS[k][r.places[0]]];
+                    int loser = winner == ids[0] ? ids[1] : ids[0];
+                    wins[winner * n + loser] += 1.0;
+
+                    if (games != nullptr) {
+                        char line[160];
+                        snprintf(line, sizeof(line), "%s,%s,%lld,%d%d%d%d,%s,%d,%d%d%d%d\n",
+                                 entrants[ids[0]]->name, entrants[ids[1]]->name, deal,
+                                 SEATINGS[k][0], SEATINGS[k][1], SEATINGS[k][2], SEATINGS[k][3],
+                                 entrants[winner]->name, r.turns,
+                                 r.places[0], r.places[1], r.places[2], r.places[3]);
+                        lines += line;
+                    }
+                }
+                // Stream in chunks so the file lock is rare and memory stays flat
+                if (games != nullptr && lines.size() > 64 * 1024) {
+                    std::lock_guard<std::mutex> lock(gamesMutex);
+                    fputs(lines.c_str(), games);
+                    lines.clear();
+                }
+            }
+            if (games != nullptr && !lines.empty()) {
+                std::lock_guard<std::mutex> lock(gamesMutex);
+                fputs(lines.c_str(), games);
+            }
+        });
+    }
+    for (std::thread& worker : pool) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (games != nullptr && games != stdout) fclose(games);
+
+    std::vector<double> wins(n * n, 0.0);
+    for (const auto& counts : perThread) {
+        for (int i = 0; i < n * n; i++) wins[i] += counts[i];
+    }
+    std::vector<double> elo = FitRatings(wins, n);
+
+    // Parametric bootstrap: redraw every pair's wins from its observed rate
+    std::vector<std::vector<double>> samples(n);
+    SimRng rng(seed ^ 0xB0075712ULL);
+    for (int b = 0; b < BOOTSTRAP_SAMPLES; b++) {
+        std::vector<double> resampled(n * n, 0.0);
+        for (auto [x, y] : pairs) {
+            long long played = (long long)(wins[x * n + y] + wins[y * n + x]);
+            if (played == 0) continue;
+            resampled[x * n + y] = Binomial(rng, played, wins[x * n + y] / played);
+            resampled[y * n + x] = played - resampled[x * n + y];
+        }
+        std::vector<double> e = FitRatings(resampled, n);
+        for (int a = 0; a < n; a++) samples[a].push_back(e[a]);
+    }
+
+    long long played = jobs * 6;
+    fprintf(stderr, "%lld games in %.2fs (%.0f games/s, %d threads, %lld unfinished)\n",
+            played, seconds, played / seconds, threads, unfinished.load());
+    fprintf(stderr, "%-10s %10s %8s %8s %17s\n", "policy", "games", "wins", "elo", "95% interval");
+    for (int a = 0; a < n; a++) {
+        double won = 0.0, total = 0.0;
+        for (int b = 0; b < n; b++) {
+            won += wins[a * n + b];
+            total += wins[a * n + b] + wins[b * n + a];
+        }
+        std::sort(samples[a].begin(), samples[a].end());
+        double lo = samples[a][BOOTSTRAP_SAMPLES * 25 / 1000];
+        double hi = samples[a][BOOTSTRAP_SAMPLES * 975 / 1000 - 1];
+        fprintf(stderr, "%-10s %10.0f %8.4f %8.0f %8.0f .. %5.0f\n",
+                entrants[a]->name, total, total > 0.0 ? won / total : 0.0, elo[a], lo, hi);
+    }
+    return 0;
+}